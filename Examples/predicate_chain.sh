@@ -0,0 +1,24 @@
+#!/bin/sh
+##################################################
+## Long chains of predicates (benchmark of the dependency graph)
+##################################################
+##
+## Usage: sh predicate_chain.sh n [chain|ring] > chain.aspx
+##
+## Writes a program with n+1 predicates p0, ..., pn:
+##   p0(X) :- p1(X).  p1(X) :- p2(X).  ...  pn(1..3).
+## - chain:	each predicate is its own scc, and the scc are all on one path
+## - ring:	pn(X) :- p0(X). closes the chain, so that all predicates are in one scc
+##
+## With n from 100000 to 1000000, this is a test for the computation of the
+## scc of the dependency graph and for the memory used by the graph.
+
+n=${1:-100000}
+mode=${2:-chain}
+awk -v n="$n" -v mode="$mode" 'BEGIN {
+    for (i = 0; i < n; i++)
+        printf("p%d(X) :- p%d(X).\n", i, i + 1);
+    printf("p%d(1..3).\n", n);
+    if (mode == "ring")
+        printf("p%d(X) :- p0(X).\n", n);
+}'
@@ -74,6 +74,14 @@ statusEnum AffectLiteral::nextSoftMatch(statusEnum){
 }
 
 
+// the right term must be ground (the variable is bound by the literal, or tested if it is already bound)
+bool AffectLiteral::isEvaluable(const variableSet& vs){
+    variableSet rightVars;
+    _args->addVariables(rightVars);
+    return std::includes(vs.begin(), vs.end(), rightVars.begin(), rightVars.end());
+}
+
+
 Literal * AffectLiteral::createPositiveClone(MapVariables& mapVar){ 
     return new AffectLiteral(_left_member->getClone(mapVar), _args->at(0)->getClone(mapVar));
 }
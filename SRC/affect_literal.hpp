@@ -61,6 +61,9 @@ class AffectLiteral : public Literal{
         statusEnum nextSoftMatch(statusEnum);
 
         Literal* createPositiveClone(MapVariables& mapVar);
+
+        /// the right term must be ground
+        bool isEvaluable(const variableSet& vs);
 	
 
     protected:
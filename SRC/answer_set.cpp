@@ -0,0 +1,63 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+#include "answer_set.hpp"
+#include "predicate.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+AnswerSet::Atom::Atom(Predicate* p, const Tuple& tuple) : _pred(p), _tuple(tuple){}
+
+
+// as Predicate::prettyPrintAllInstances
+AnswerSet::AnswerSet(int number) : _number(number), _atoms(){
+    const mapPredicate& preds = Predicate::getPredicates();
+    for (mapPredicate::const_iterator it = preds.begin(); it != preds.end(); ++it) {
+        Predicate* p = it->second;
+        if (p->isShown())
+            for (int id = 0; id < p->getInstanceNumber(); ++id)
+                _atoms.push_back(Atom(p, p->getInstance(id)));
+    }
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+AnswerSetHandler::~AnswerSetHandler(){}
+
+
+//********************************** GETTERS *********************************//
+
+const std::string& AnswerSet::Atom::getPredicate() const{
+    return _pred->getName();
+}
+
+
+int AnswerSet::Atom::getArity() const{
+    return _pred->getArity();
+}
+
+
+//********************************* OPERATORS ********************************//
+
+std::ostream& operator << (std::ostream& os, const AnswerSet::Atom& a){
+    return os << *a._pred << a._tuple;
+}
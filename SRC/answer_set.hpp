@@ -0,0 +1,151 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+#ifndef _ANSWER_SET_HPP_
+#define _ANSWER_SET_HPP_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tuple.hpp"
+
+class Predicate;
+
+
+
+/**
+ * An AnswerSet gives the atoms of an answer set to the program embedding the solver (cf. Solver),
+ * instead of printing them : each atom is a record of its predicate and of its tuple of ground terms.
+ * The atoms are those of the shown predicates, in the order of the printed answer set.
+ *
+ * An answer set refers to the extensions of the predicates : it is valid until its handler returns
+ * (cf. AnswerSetHandler), the search changing the extensions afterwards. The terms are hash-consed and
+ * remain valid until the program is deleted.
+ */
+class AnswerSet{
+
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        /// an atom of the answer set
+        class Atom{
+            protected:
+                Predicate* _pred;
+                Tuple _tuple;
+
+            public:
+                Atom(Predicate* p, const Tuple& tuple);
+
+                /// name of the predicate, beginning with - for a classically negated one
+                const std::string& getPredicate() const;
+
+                int getArity() const;
+
+                inline const Tuple& getTuple() const;
+
+            private:
+                /// written as in a program : p(a,1)
+                friend std::ostream& operator << (std::ostream& os, const Atom& a);
+        };
+
+        typedef std::vector<Atom>::const_iterator const_iterator;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// number of the answer set in the search (from 1)
+        int _number;
+
+        std::vector<Atom> _atoms;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        /// the answer set of number number, made of the current extensions of the shown predicates
+        AnswerSet(int number);
+
+
+//********************************** GETTERS *********************************//
+
+        inline int getNumber() const;
+
+        /// number of atoms
+        inline int size() const;
+
+        inline const_iterator begin() const;
+        inline const_iterator end() const;
+
+
+}; // class AnswerSet
+
+
+
+/**
+ * An AnswerSetHandler receives the answer sets found by the search (cf. Program::setAnswerSetHandler),
+ * one after the other.
+ */
+class AnswerSetHandler{
+
+//******************************** DESTRUCTOR ********************************//
+
+    public:
+        virtual ~AnswerSetHandler();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// called for each answer set found, return false to stop the search
+        virtual bool answerSet(const AnswerSet& as) = 0;
+
+
+}; // class AnswerSetHandler
+
+
+//********************************** GETTERS *********************************//
+
+inline const Tuple& AnswerSet::Atom::getTuple() const{
+    return _tuple;
+}
+
+
+inline int AnswerSet::getNumber() const{
+    return _number;
+}
+
+
+inline int AnswerSet::size() const{
+    return _atoms.size();
+}
+
+
+inline AnswerSet::const_iterator AnswerSet::begin() const{
+    return _atoms.begin();
+}
+
+
+inline AnswerSet::const_iterator AnswerSet::end() const{
+    return _atoms.end();
+}
+
+
+
+#endif // _ANSWER_SET_HPP_
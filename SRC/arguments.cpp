@@ -33,6 +33,9 @@ Argument::Argument(): Term::Vector(){}
 Argument::Argument(const Argument& a) : Term::Vector(a){}
 
 
+Argument::Argument(const Tuple& t) : Term::Vector(t.begin(), t.end()){}
+
+
 //******************************** DESTRUCTOR ********************************//
 
 Argument::~Argument(){
@@ -56,6 +59,19 @@ Argument* Argument::applySubstitution(){
 }
 
 
+// tuple keeps its capacity : no allocation once it is large enough
+bool Argument::findSubstitution(Argument& tuple){
+    tuple.clear();
+    for (Argument::iterator it = begin(); it != end(); it++) {
+        Term* t = (*it)->findSubstitution();
+        if (!t)
+            return false;
+        tuple.push_back(t);
+    }
+    return true;
+}
+
+
 // return true if grounded arguments *this and *arg are the same
 bool Argument::isTheSameInstance(Argument *arg){
     Argument::iterator i1 = begin();
@@ -28,6 +28,7 @@
 
 #include "definition.hpp"
 #include "term.hpp"
+#include "tuple.hpp"
 #include "variable.hpp"
 
 
@@ -45,6 +46,9 @@ class Argument : public Term::Vector{
 
         Argument(const Argument&);
 
+        /// copy of the terms of a tuple of an extension
+        explicit Argument(const Tuple&);
+
 
 //******************************** DESTRUCTOR ********************************//
 
@@ -70,8 +74,15 @@ class Argument : public Term::Vector{
         /// try to match argument  with the ground terms arg 
         inline bool match(const Argument* arg);
 
+        /// idem with a tuple of an extension
+        inline bool match(const Tuple& tuple);
+
         Argument* applySubstitution();
 
+        /// ground terms of the current substitution, in tuple (cf. Term::findSubstitution)
+        /// return false if one of them does not exist : no tuple of an extension contains it
+        bool findSubstitution(Argument& tuple);
+
         bool isTheSameInstance(Argument* arg);
 
         /// depth of the deepest term
@@ -140,5 +151,16 @@ inline bool Argument::match(const Argument* arg){
 }
 
 
+inline bool Argument::match(const Tuple& tuple){
+    Argument::iterator i1 = begin();
+    Tuple::const_iterator i2 = tuple.begin();
+    while ((i1 != end()) && (*i1)->match(*i2)){
+        i1++;
+        i2++;
+    }
+    return (i1 == end());
+}
+
+
 
 #endif // _ARGUMENT_HPP_
@@ -28,17 +28,12 @@
 //****************************************************************************//
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-arithExprSet ArithExpr::_arithExprSet;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 void ArithExpr::delete_all(){
-    for (arithExprSet::iterator it = _arithExprSet.begin(); it != _arithExprSet.end(); it++)
+    for (arithExprSet::iterator it = _arithExprSet().begin(); it != _arithExprSet().end(); it++)
         delete *it;
-    _arithExprSet.clear();
+    _arithExprSet().clear();
 }
 
 
@@ -47,12 +42,12 @@ void ArithExpr::delete_all(){
 ArithExpr::ArithExpr(opEnum op, Term* t){
     _operator = Operator::new_Operator(op);
     _right_term = t;
-    ArithExpr::_arithExprSet.insert(this);
+    ArithExpr::_arithExprSet().insert(this);
 }
 
 
 ArithExpr::ArithExpr(Operator* op, Term* t) : _operator(op), _right_term(t){
-    ArithExpr::_arithExprSet.insert(this);
+    ArithExpr::_arithExprSet().insert(this);
 }
 
 
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <vector>
 
+#include "context.hpp"
 #include "definition.hpp"
 #include "operator.hpp"
 #include "term.hpp"
@@ -46,7 +47,7 @@ class ArithExpr : public Term{  // abstract class
 //************************** MEMBER STATIC VARIABLES *************************//
 
     protected:
-        static arithExprSet _arithExprSet;
+        static inline arithExprSet& _arithExprSet();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -97,6 +98,13 @@ class ArithExpr : public Term{  // abstract class
 }; // class ArithExpr
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline arithExprSet& ArithExpr::_arithExprSet(){
+    return Context::current()->_arithExprSet;
+}
+
+
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
 inline bool ArithExpr::isArithExpr(){
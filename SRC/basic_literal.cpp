@@ -28,18 +28,18 @@
 
 //******************************* CONSTRUCTORS *******************************//
 
-BasicLiteral::BasicLiteral(){}
+BasicLiteral::BasicLiteral() : _index_pos(-1), _part(0), _parts(1){}
 
 
-BasicLiteral::BasicLiteral(const BasicLiteral& l) : Literal(l), _pred(l._pred), _status(NO_){}
+BasicLiteral::BasicLiteral(const BasicLiteral& l) : Literal(l), _pred(l._pred), _status(NO_), _index_pos(-1), _part(0), _parts(1){}
 
 
-BasicLiteral::BasicLiteral(std::string* s, Argument* tv, Graph& g) : Literal(tv), _status(NO_){
+BasicLiteral::BasicLiteral(std::string* s, Argument* tv, Graph& g) : Literal(tv), _status(NO_), _index_pos(-1), _part(0), _parts(1){
     _pred = Predicate::newPredicate(*s, _args->size(), g);
 }
 
 
-BasicLiteral::BasicLiteral(Predicate* p, Argument* tv) : Literal(tv), _pred(p), _status(NO_){}
+BasicLiteral::BasicLiteral(Predicate* p, Argument* tv) : Literal(tv), _pred(p), _status(NO_), _index_pos(-1), _part(0), _parts(1){}
 
 
 //************************** OTHER MEMBER FUNCTIONS **************************//
@@ -60,7 +60,7 @@ bool BasicLiteral::isTheSameLiteral(BasicLiteral* l){
 
 
 // tv are ground terms
-bool BasicLiteral::match(const Argument* tv){
+bool BasicLiteral::match(const Tuple& tv){
     if (_args->match(tv))
         return true;
     else {
@@ -70,19 +70,44 @@ bool BasicLiteral::match(const Argument* tv){
 }
 
 
+// choose : search the most selective bound position (first match), otherwise keep _index_pos if it is still bound
+// (a position bound by previous literals is valid for all the matches of the atom, whichever is chosen)
+const intVector* BasicLiteral::boundSlots(bool choose){
+    if (choose || (_index_pos < 0) || !isBoundPosition(_index_pos)) {
+        const intVector* slots = NULL;
+        _index_pos = -1;
+        for (int pos = 0; pos < (int) _args->size(); ++pos) {
+            if (isBoundPosition(pos)) {
+                const intVector& s = getPred()->getInstanceIndexes(pos, (*_args)[pos]->applySubstitution());
+                if (!slots || (s.size() < slots->size())) {
+                    slots = &s;
+                    _index_pos = pos;
+                }
+            }
+        }
+        return slots;
+    }
+    else
+        return &getPred()->getInstanceIndexes(_index_pos, (*_args)[_index_pos]->applySubstitution());
+}
+
+
 bool BasicLiteral::firstTrueMatchBis(){
     if (_free_vars.empty()) {   // atom is already ground
-        Argument* tv = applySubstitutionOnArgs();
+        const Argument* tv = groundArgs();
+        if (!tv)
+            return false;
         statusEnum status = getPred()->containInstance(*tv,_first_index, _last_index);
-        delete tv;
+        if (Dependencies::isEnabled())
+            _current_index = getPred()->getInstanceIndex(*tv, _first_index, _last_index);
         return (status >= TRUE_);   // TRUE or TRUE_MBT
     }
     else {
-        const Argument* tuple = getPred()->firstTrueInstance(_current_index, _first_index, _last_index);
-        while (tuple && !match(tuple)) {
-            tuple = getPred()->nextTrueInstance(_current_index, _last_index);
-        }
-        return (tuple != NULL);
+        const intVector* slots = boundSlots(true);  // if not NULL, only tuples that agree with a bound argument are tried
+        Tuple tuple = firstTrueTuple(slots);
+        while (!tuple.isNull() && !match(tuple))
+            tuple = nextTrueTuple(slots);
+        return !tuple.isNull();
     }
 }
 
@@ -91,11 +116,12 @@ bool BasicLiteral::nextTrueMatch(){
     if (_free_vars.empty()) // atom was already ground
         return false;
     else {
-        const Argument* tuple;
+        const intVector* slots = boundSlots(false);
+        Tuple tuple;
         do {
-            tuple = getPred()->nextTrueInstance(_current_index, _last_index);
-        } while (tuple && !match(tuple));
-        return (tuple != NULL);
+            tuple = nextTrueTuple(slots);
+        } while (!tuple.isNull() && !match(tuple));
+        return !tuple.isNull();
     }
 }
 
@@ -104,17 +130,18 @@ bool BasicLiteral::nextTrueMatch(){
 // if a true or mbt match is found for this literal, return the minimum value between match status of this literal and the previous ones (MBT < TRUE)
 statusEnum BasicLiteral::firstSoftMatchBis(statusEnum previousStatus){
     if (_free_vars.empty()) {   // atom is already ground
-        Argument* tv = applySubstitutionOnArgs();
-        statusEnum status = getPred()->containInstance(*tv, _first_index, _last_index);
-        delete tv;
+        const Argument* tv = groundArgs();
+        statusEnum status = tv ? getPred()->containInstance(*tv, _first_index, _last_index) : NO_;
+        if (Dependencies::isEnabled())
+            _current_index = tv ? getPred()->getInstanceIndex(*tv, _first_index, _last_index) : -1;
         _status = std::min(status, previousStatus);
         return _status;
     }
     else{
-        std::pair<const Argument*, statusEnum> t_s = getPred()->firstSoftInstance(_current_index, _first_index, _last_index);
-        while (t_s.second && !match(t_s.first)) {
-            t_s = getPred()->nextSoftInstance(_current_index, _last_index);
-        }
+        const intVector* slots = boundSlots(true);
+        std::pair<Tuple, statusEnum> t_s = firstSoftTuple(slots);
+        while (t_s.second && !match(t_s.first))
+            t_s = nextSoftTuple(slots);
         _status = std::min(t_s.second, previousStatus);
         return _status;
     }
@@ -125,9 +152,10 @@ statusEnum BasicLiteral::nextSoftMatch(statusEnum previousStatus){
     if (_free_vars.empty()) // atom was already ground
         return NO_;
     else {
-        std::pair<const Argument*, statusEnum> t_s;
+        const intVector* slots = boundSlots(false);
+        std::pair<Tuple, statusEnum> t_s;
         do{
-            t_s = getPred()->nextSoftInstance(_current_index, _last_index);
+            t_s = nextSoftTuple(slots);
         } while (t_s.second && !match(t_s.first));
         _status = std::min(t_s.second, previousStatus);
         return _status;
@@ -135,13 +163,42 @@ statusEnum BasicLiteral::nextSoftMatch(statusEnum previousStatus){
 }
 
 
+// estimated number of tuples of the extension that match the atom when variables of vs are bound
+// with useExtension, an argument bound to a constant (resp. a variable) is supposed to select
+// its own number of tuples (resp. the mean number of tuples by term), as the argument indexes do
+// without useExtension, each bound argument is supposed to divide by 10 the number of matches
+double BasicLiteral::estimateMatches(const variableSet& vs, bool useExtension){
+    double estimate = useExtension ? getPred()->getEndIndex() + 1 : 1000;
+    double size = estimate;
+    bool ground = true;
+    for (int pos = 0; pos < (int) _args->size(); ++pos) {
+        Term* t = (*_args)[pos];
+        bool boundVar = t->isVariable() && (vs.find(static_cast<Variable*>(t)) != vs.end());
+        if (boundVar || t->isNumConst() || t->isSymbConst()) {
+            if (!useExtension)
+                estimate /= 10;
+            else if (boundVar)
+                estimate = std::min(estimate, size / std::max(1, getPred()->getTermNumber(pos)));
+            else
+                estimate = std::min(estimate, (double) getPred()->getInstanceIndexes(pos, t).size());
+        }
+        else if (t->isVariable())
+            ground = false;
+        else if (ground && !t->isConst()) { // functional term or arithmetic expression
+            variableSet termVars;
+            t->addVariables(termVars);
+            ground = std::includes(vs.begin(), vs.end(), termVars.begin(), termVars.end());
+        }
+    }
+    return ground ? std::min(estimate, 1.0) : estimate;     // a ground atom is a single lookup
+}
+
+
 // require atom is already ground
 // return status if atom is in the extension of the predicate
 statusEnum BasicLiteral::isInstance(){
-    Argument* tv = applySubstitutionOnArgs();
-    statusEnum ok = getPred()->containInstance(*tv);
-    delete tv;
-    return ok;
+    const Argument* tv = groundArgs();
+    return tv ? getPred()->containInstance(*tv) : NO_;
 }
 
 
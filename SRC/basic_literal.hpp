@@ -47,12 +47,23 @@ class BasicLiteral : public Literal{
 
         int _last_index;
 
+        /// argument position (bound before matching) used to look up the extension, -1 if none
+        int _index_pos;
+
+        /// when marked, the literal matches part number _part (from 0) of _parts parts of the delta of _pred
+        int _part;
+
+        int _parts;
+
         /// back-track stack for _status
         statusStack _status_stack;
 
         /// back-track stack for _current_index
         intStack _index_stack;
 
+        /// tuple of the current substitution of a ground atom, reused from a match to the next (cf. groundArgs)
+        Argument _ground;
+
 
 //******************************* CONSTRUCTORS *******************************//
 
@@ -72,6 +83,15 @@ class BasicLiteral : public Literal{
 
         inline statusEnum getStatus();
 
+        /// first index of the extension matched by the literal (cf. setMark)
+        inline int getFirstIndex() const;
+
+        /// last index of the extension matched by the literal
+        inline int getLastIndex() const;
+
+        /// index in the extension of the current instance, -1 if it has none (cf. Body::getAtoms)
+        inline int getCurrentIndex() const;
+
 
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
@@ -87,7 +107,22 @@ class BasicLiteral : public Literal{
         inline bool hasPredIn(Node::Set& ns);
 
         /// tv are ground terms
-        virtual bool match(const Argument* tv);
+        virtual bool match(const Tuple& tv);
+
+        /// first true tuple of the part of the extension matched by the literal whose index is in slots
+        /// (in the whole part if slots is NULL), the literal keeping its index (cf. RulePlan), or the null tuple
+        inline Tuple firstTrueTuple(const intVector* slots);
+
+        /// idem for the next true tuple after the current index
+        inline Tuple nextTrueTuple(const intVector* slots);
+
+        /// idem with true or mbt tuples
+        inline std::pair<Tuple, statusEnum> firstSoftTuple(const intVector* slots);
+
+        inline std::pair<Tuple, statusEnum> nextSoftTuple(const intVector* slots);
+
+        /// status of the current match (cf. getStatus)
+        inline void setStatus(statusEnum st);
 
         /// idem for the next matching tuple
         bool nextTrueMatch();
@@ -121,8 +156,20 @@ class BasicLiteral : public Literal{
         /// true if atom predicate is already solved
         inline bool isSolved();
 
+        /// decisions from which the matched tuple is derived
+        inline const decisionSet* getDependencies();
+
+        /// a positive atom binds its own variables, except for a "not_p" atom which must be ground
+        inline bool isEvaluable(const variableSet& vs);
+
+        /// estimated number of tuples of the extension that match the atom when variables of vs are bound
+        double estimateMatches(const variableSet& vs, bool useExtension);
+
         inline void setMark(markEnum m);
 
+        /// the literal matches only one part of the delta when marked (cf. ParallelFixpoint)
+        inline void setDeltaPart(int part, int parts);
+
         inline void setDelta();
 
         inline void initDelta();
@@ -146,6 +193,17 @@ class BasicLiteral : public Literal{
         /// idem for true or mbt tuple 
         statusEnum firstSoftMatchBis(statusEnum);
 
+        /// tuple of the atom under the current substitution, without allocation,
+        /// NULL if one of its terms does not exist (the atom is then in no extension)
+        inline const Argument* groundArgs();
+
+        /// return true if the argument at position pos is ground before matching this atom
+        inline bool isBoundPosition(int pos);
+
+        /// indexes of the tuples of the extension that agree with the bound argument at position _index_pos
+        /// return NULL if no argument position is bound
+        const intVector* boundSlots(bool choose);
+
 
 }; // class BasicLiteral
 
@@ -162,8 +220,56 @@ inline statusEnum BasicLiteral::getStatus(){
 }
 
 
+inline int BasicLiteral::getFirstIndex() const{
+    return _first_index;
+}
+
+
+inline int BasicLiteral::getLastIndex() const{
+    return _last_index;
+}
+
+
+inline int BasicLiteral::getCurrentIndex() const{
+    return _current_index;
+}
+
+
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
+inline Tuple BasicLiteral::firstTrueTuple(const intVector* slots){
+    return slots ?
+             getPred()->firstTrueInstance(_current_index, _first_index, _last_index, *slots) :
+             getPred()->firstTrueInstance(_current_index, _first_index, _last_index);
+}
+
+
+inline Tuple BasicLiteral::nextTrueTuple(const intVector* slots){
+    return slots ?
+             getPred()->nextTrueInstance(_current_index, _last_index, *slots) :
+             getPred()->nextTrueInstance(_current_index, _last_index);
+}
+
+
+inline std::pair<Tuple, statusEnum> BasicLiteral::firstSoftTuple(const intVector* slots){
+    return slots ?
+             getPred()->firstSoftInstance(_current_index, _first_index, _last_index, *slots) :
+             getPred()->firstSoftInstance(_current_index, _first_index, _last_index);
+}
+
+
+inline std::pair<Tuple, statusEnum> BasicLiteral::nextSoftTuple(const intVector* slots){
+    return slots ?
+             getPred()->nextSoftInstance(_current_index, _last_index, *slots) :
+             getPred()->nextSoftInstance(_current_index, _last_index);
+}
+
+
+inline void BasicLiteral::setStatus(statusEnum st){
+    _status = st;
+}
+
+
 inline int BasicLiteral::getSccIndex(){
     return getPred()->getNode()->getSccIndex();
 }
@@ -230,16 +336,32 @@ inline bool BasicLiteral::isSolved(){
 }
 
 
+// the matched tuple has an index in the extension, unless it is known by the closed world assumption
+inline const decisionSet* BasicLiteral::getDependencies(){
+    return (_current_index >= 0) ? _pred->getDependencies(_current_index) : _pred->getSolvedDependencies();
+}
+
+
+// a positive atom binds its own variables
+// an atom "not_p(t)" is a test that must be ground : the extension of "not_p" is complete only when "p" is solved
+inline bool BasicLiteral::isEvaluable(const variableSet& vs){
+    return !_pred->isNegatedPredicate() || Literal::isEvaluable(vs);
+}
+
+
 inline void BasicLiteral::setMark(markEnum m){
     switch (_mark = m) {
         case NON_MARKED:
             _first_index = _pred->getBeginIndex();
             _last_index = _pred->getDeltaEndIndex();
             break;
-        case MARKED:
-            _first_index = _pred->getDeltaBeginIndex();
-            _last_index = _pred->getDeltaEndIndex();
+        case MARKED: {
+            int begin = _pred->getDeltaBeginIndex();
+            int size = _pred->getDeltaEndIndex() - begin + 1;
+            _first_index = begin + size * _part / _parts;
+            _last_index = begin + size * (_part + 1) / _parts - 1;
             break;
+        }
         case UNMARKED:
             _first_index = _pred->getBeginIndex();
             _last_index = _pred->getDeltaBeginIndex() - 1;
@@ -248,6 +370,28 @@ inline void BasicLiteral::setMark(markEnum m){
 }
 
 
+inline const Argument* BasicLiteral::groundArgs(){
+    return _args->findSubstitution(_ground) ? &_ground : NULL;
+}
+
+
+// return true if the argument at position pos is ground before matching this atom
+// (a constant or a variable bound by previous literals)
+inline bool BasicLiteral::isBoundPosition(int pos){
+    Term* t = (*_args)[pos];
+    if (t->isVariable())
+        return !isFreeVar(static_cast<Variable*>(t));
+    else
+        return t->isNumConst() || t->isSymbConst();
+}
+
+
+inline void BasicLiteral::setDeltaPart(int part, int parts){
+    _part = part;
+    _parts = parts;
+}
+
+
 inline void BasicLiteral::setDelta(){}
 
 
@@ -26,23 +26,13 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-// Handler for dynamic libraries
-void* BuiltInLiteral::_handle = NULL;
-
-
-// List of loaded dynmic libraries
-std::vector<void*> BuiltInLiteral::_libs;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 // Initializes the handler dor dynamic libraries
 void BuiltInLiteral::initDynamicLibraries(){
-    if (!_handle) {
-        _handle = dlopen(NULL, RTLD_LAZY);
-        if (!_handle)
+    if (!_handle()) {
+        _handle() = dlopen(NULL, RTLD_LAZY);
+        if (!_handle())
             throw RuntimeExcept(dlerror());
     }
 }
@@ -61,7 +51,7 @@ void BuiltInLiteral::addDynamicLibrary(const std::string& filename){
     if (!handler)
         throw RuntimeExcept(dlerror());
 
-    return _libs.push_back(handler);
+    return _libs().push_back(handler);
 }
 
 
@@ -69,13 +59,13 @@ void BuiltInLiteral::addDynamicLibrary(const std::string& filename){
 void BuiltInLiteral::closeDynamicLibraries(){
     typedef std::vector<void*>::const_reverse_iterator  iterator;
 
-    for (iterator it = _libs.rbegin(), end = _libs.rend(); it != end; ++it)
+    for (iterator it = _libs().rbegin(), end = _libs().rend(); it != end; ++it)
         dlclose(*it);
-    _libs.clear();
+    _libs().clear();
 
-    if (_handle) {
-        dlclose(_handle);
-        _handle = NULL;
+    if (_handle()) {
+        dlclose(_handle());
+        _handle() = NULL;
     }
 
     BuiltInPredicate::deleteAll();  // TODO Not here
@@ -92,7 +82,7 @@ BuiltInLiteral::BuiltInLiteral(const std::string& name, Argument* args, bool sig
     void (*built_in)(std::string&, BuiltInPredicate::UserFunction&);
     // Recommended way to cast from void* to function pointer
 	void **tmp = reinterpret_cast<void**> (&built_in);
-    *tmp = dlsym(_handle, name.c_str());
+    *tmp = dlsym(_handle(), name.c_str());
 
     char* error = dlerror();
     if (error)
@@ -155,6 +145,16 @@ statusEnum BuiltInLiteral::nextSoftMatch(statusEnum){
 }
 
 
+// input arguments (all but the output ones at the end) must be ground
+bool BuiltInLiteral::isEvaluable(const variableSet& vs){
+    variableSet inputVars;
+    unsigned int inputs = (_args->size() > _BIPred->getOutputArgsNumber()) ? _args->size() - _BIPred->getOutputArgsNumber() : 0;
+    for (unsigned int i = 0; i < inputs; ++i)
+        _args->at(i)->addVariables(inputVars);
+    return std::includes(vs.begin(), vs.end(), inputVars.begin(), inputVars.end());
+}
+
+
 Literal* BuiltInLiteral::createPositiveClone(MapVariables& mapVar){
     return new BuiltInLiteral(_BIPred, _args->clone(mapVar), _sign);
 }
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "built_in_predicate.hpp"
+#include "context.hpp"
 #include "literal.hpp"
 
 
@@ -56,14 +57,14 @@ class BuiltInLiteral : public Literal{
          * 
          * @sa initDynamicLibraries(), closeDynamicLibraries()
          */
-        static void* _handle;
+        static inline void*& _handle();
 
         /**
          * @brief List of loaded dynamic libraries.
          * 
          * @sa addDynamicLibrary(const std::string&), closeDynamicLibraries()
          */
-        static std::vector<void*> _libs;
+        static inline std::vector<void*>& _libs();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -143,6 +144,9 @@ class BuiltInLiteral : public Literal{
 
         Literal* createPositiveClone(MapVariables& mapVar);
 
+        /// input arguments must be ground
+        bool isEvaluable(const variableSet& vs);
+
     protected:
         virtual std::ostream& put(std::ostream&);
 
@@ -156,6 +160,18 @@ class BuiltInLiteral : public Literal{
 }; // class BuiltInLiteral
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline void*& BuiltInLiteral::_handle(){
+    return Context::current()->_handle;
+}
+
+
+inline std::vector<void*>& BuiltInLiteral::_libs(){
+    return Context::current()->_libs;
+}
+
+
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
 inline std::ostream& BuiltInLiteral::put(std::ostream& os){
@@ -24,12 +24,6 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-// List of loaded built-in predicates
-std::map<std::string, BuiltInPredicate*> BuiltInPredicate::_mapPredicate;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 // Adds a new built-in predicate
@@ -37,13 +31,13 @@ BuiltInPredicate* BuiltInPredicate::newPredicate(const std::string& name, const
     typedef std::map<std::string, BuiltInPredicate*>::iterator   iterator;
 
     // Search for existing built-in predicate
-    iterator it = _mapPredicate.find(name);
-    if (it != _mapPredicate.end())
+    iterator it = _mapPredicate().find(name);
+    if (it != _mapPredicate().end())
         return it->second;
 
     // Create new built-in predicate
     BuiltInPredicate* pred = new BuiltInPredicate(name, args, f);
-    return _mapPredicate.insert(std::make_pair(name, pred)).first->second;
+    return _mapPredicate().insert(std::make_pair(name, pred)).first->second;
 }
 
 
@@ -27,6 +27,7 @@
 #include <string>
 
 #include "arguments.hpp"
+#include "context.hpp"
 
 
 
@@ -55,7 +56,7 @@ class BuiltInPredicate{
          * @sa newPredicate(const std::string&, const std::string&, UserFunction),
          *     deleteAll()
          */
-        static std::map<std::string, BuiltInPredicate*> _mapPredicate;
+        static inline std::map<std::string, BuiltInPredicate*>& _mapPredicate();
 
 	
 //***************************** MEMBER VARIABLES *****************************//
@@ -147,8 +148,16 @@ class BuiltInPredicate{
         BuiltInPredicate(const std::string& name, const std::string& args, UserFunction f);
 
 
+//********************************** GETTERS *********************************//
+
+    public:
+        /// @brief Number of output arguments (at the end of the arguments).
+        inline unsigned int getOutputArgsNumber() const;
+
+
 //********************************* OPERATORS ********************************//
 
+    protected:
         friend inline std::ostream& operator << (std::ostream&, const BuiltInPredicate&);
 
 
@@ -185,13 +194,26 @@ class BuiltInPredicate{
 
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
+inline std::map<std::string, BuiltInPredicate*>& BuiltInPredicate::_mapPredicate(){
+    return Context::current()->_mapBuiltInPredicate;
+}
+
+
 // Frees all loaded built-in predicates
 inline void BuiltInPredicate::deleteAll(){
     typedef std::map<std::string, BuiltInPredicate*>::iterator  iterator;
 
-    for (iterator it = _mapPredicate.begin(), end = _mapPredicate.end(); it != end; ++it)
+    for (iterator it = _mapPredicate().begin(), end = _mapPredicate().end(); it != end; ++it)
         delete it->second;
-    _mapPredicate.clear();
+    _mapPredicate().clear();
+}
+
+
+//********************************** GETTERS *********************************//
+
+// Number of output arguments
+inline unsigned int BuiltInPredicate::getOutputArgsNumber() const{
+    return _outputArgs;
 }
 
 
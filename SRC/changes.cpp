@@ -20,6 +20,7 @@
 
 
 #include "changes.hpp"
+#include "predicate.hpp"
 #include "program.hpp"
 
 
@@ -48,7 +49,7 @@ void Changes::recordState(Program& p){
 
 
 void Changes::recordExtensions(Program& p){
-    p.getGraph().recordExtensions(p.getCurrentScc());   // record all predicate extensions and non-extensions from SCC >= 'scc' 
+    Predicate::recordExtensions();  // record all predicate extensions and non-extensions
     _first_scc = p.getCurrentScc();	
 }
 
@@ -64,9 +65,9 @@ void Changes::recordCurrentInstanceNDR(ruleMultimap::iterator it){
 
 void Changes::recordIntermediarySccExtensions(Program& p, int lastIndex){
     if (intermediary())
-        p.getGraph().updateExtensions(_first_scc);  // for predicate from scc >= sccIndex
+        Predicate::updateExtensions();
     else
-        p.getGraph().recordExtensions(_first_scc);  // for predicate from scc >= sccIndex
+        Predicate::recordExtensions();
     if (!_intermediary_scc) {
         _intermediary_scc = true;
     }
@@ -82,11 +83,11 @@ void Changes::recordIntermediarySccExtensions(Program& p, int lastIndex){
 // if a supported non blocked rule leads to contradictory conclusion,
 // it is prohibited or, if body minus contains only one literal l, 
 // l becomes MBT, thus extensions have been modified and need to be recorded
-void Changes::recordIntermediaryMbtExtensions(Program& p){
+void Changes::recordIntermediaryMbtExtensions(Program&){
     if (intermediary())
-        p.getGraph().updateExtensions(_first_scc);  // for predicate from scc >= sccIndex
+        Predicate::updateExtensions();
     else
-        p.getGraph().recordExtensions(_first_scc);  // for predicate from scc >= sccIndex
+        Predicate::recordExtensions();
     if (!_intermediary_mbt)
         _intermediary_mbt = true;
 }
@@ -94,10 +95,10 @@ void Changes::recordIntermediaryMbtExtensions(Program& p){
 
 // restore previous extensions and non-extensions
 // and clear _atoms_queue and _not_atoms_queue
-void Changes::retropropagate(Program& p){
+void Changes::retropropagate(Program&){
     while (!_atoms_queue.empty())       // clear _atoms_queue
         _atoms_queue.pop();
-    p.getGraph().restoreExtensionsWithoutPop(p.getCurrentScc());    // restore all predicate extensions and non-extensions 
+    Predicate::restoreExtensionsWithoutPop();   // restore all predicate extensions and non-extensions
 }
 
 
@@ -106,25 +107,28 @@ void Changes::retropropagateSolved(Program& p, int firstScc, int lastScc){
     p.getGraph().restoreNonSolvedScc(firstScc, lastScc+1);
     while (!_atoms_queue.empty())   // clear _atoms_queue
         _atoms_queue.pop();
-    p.getGraph().restoreExtensionsWithoutPop(firstScc);
+    Predicate::restoreExtensionsWithoutPop();
     p.setCurrentScc(firstScc);
 }
 
 
 void Changes::restoreAll(Program& p){
-    if (intermediary()) // an intermediary state has been recorded
-        p.getGraph().restoreExtensions(_first_scc);
-    p.getGraph().restoreExtensions(_first_scc); // restore all extensions and non-extensions of predicates from SCC >=_first_scc
-    restoreProhibitedRules(p.getProhibitedRules()); // restore previous prohibited rules
+    // restore all extensions and non-extensions of predicates, an intermediary state may have been recorded
+    Predicate::restoreExtensions(recordedStates());
+    restoreSearch(p);
+}
+
+
+void Changes::restoreSearch(Program& p){
+    restoreProhibitedRules(p); // restore previous prohibited rules
     restorePreviousInstanceNDR(p);  // record previous state of search for NDR (scc and rule)
 }
 
 
-void Changes::restoreProhibitedRules(ruleSet& prohib){
+void Changes::restoreProhibitedRules(Program& p){
     for (ruleSet::iterator it = _added_prohibited.begin(); it != _added_prohibited.end(); it++) {
-        prohib.erase(*it);
-        Rule* clone = (*it)->getClone();
-        clone->getBodyPlus()->removeBodyPlusDefiniteConstraint(clone);
+        p.getProhibitedRules().erase(*it);
+        p.removeProhibitedClone((*it)->getClone());
         delete (*it);
     }
     _added_prohibited.clear();
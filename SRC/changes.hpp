@@ -89,6 +89,9 @@ class Changes{
 
         inline bool intermediary();
 
+        /// number of states recorded in the extensions of predicates
+        inline unsigned int recordedStates();
+
         inline void addProhibited(Rule*);
 
         inline void incNumberNDR();
@@ -109,7 +112,10 @@ class Changes{
 
         void restoreAll(Program& p);
 
-        void restoreProhibitedRules(ruleSet&);
+        /// restore all but the extensions of predicates (cf. Program::backjump)
+        void restoreSearch(Program& p);
+
+        void restoreProhibitedRules(Program& p);
 
         void restorePreviousInstanceNDR(Program& p);
 
@@ -151,6 +157,11 @@ inline bool Changes::intermediary(){
 }
 
 
+inline unsigned int Changes::recordedStates(){
+    return intermediary() ? 2 : 1;
+}
+
+
 inline void Changes::addProhibited(Rule* r){
     _added_prohibited.insert(r);
 }
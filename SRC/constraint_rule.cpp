@@ -64,14 +64,16 @@ ConstraintRule::~ConstraintRule(){}
 
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
-// ordonnancement du corps de la règle TODO 
+// ordonnancement du corps de la règle (cf. Body::order)
 // initialisation of _recursiveBody with literals which are not already solved (there is none)
 // and initialisation of previous and free vars
 void ConstraintRule::orderBody(){
+    unsetBodyOrder();
     _orderedBody.clear();
     _recursiveBody.clear();
     _bodyMinus->order(_recursiveBody, *_bodyPlus, _orderedBody);    // copie de body+ et body- vers _orderedBody
     _orderedBody.initVars();
+    compilePlan();
 }
 
 
@@ -0,0 +1,58 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+#include "built_in_literal.hpp"
+#include "context.hpp"
+#include "dependencies.hpp"
+#include "functor.hpp"
+#include "list.hpp"
+#include "predicate.hpp"
+#include "term.hpp"
+
+
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+__thread Context* Context::_current = NULL;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+Context::Context()
+ : _mapPredicate(), _truePredicate(NULL), _trail(), _records(), _stamp(0), _stamps(0), _dependencies(new Dependencies()),
+   _mapBuiltInPredicate(), _handle(NULL), _libs(), _factoryMutex(), _indexMutex(),
+   _functors(), _mapNumConst(), _mapOperator(), _arithExprSet(), _mapRangeTerm(), _listFunctor(NULL), _emptyList(NULL),
+   _maxInt(1024), _maxDepth(16), _nextNumber(0), _created(0), _costBasedOrder(true), _joinEnabled(true){
+    Scope scope(*this);
+    List::init();
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+// as the destructor of a program, which leaves the terms of the lists
+Context::~Context(){
+    Scope scope(*this);
+    Dependencies::clear();
+    Predicate::deleteAll();
+    Term::delete_all();
+    Functor::deleteAll();
+    BuiltInLiteral::closeDynamicLibraries();
+    delete _dependencies;
+}
@@ -0,0 +1,166 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+#ifndef _CONTEXT_HPP_
+#define _CONTEXT_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "definition.hpp"
+#include "threads.hpp"
+
+class BuiltInPredicate;
+class Dependencies;
+class Functor;
+class List;
+
+
+
+/**
+ * A Context holds the tables of a program being solved : its predicates and back-track trail, the
+ * decisions of its search, its hash-consed terms, the built-in predicates and dynamic libraries of its
+ * #include directives, the limits of its terms and the options of the compilation of its rules.
+ *
+ * The classes of these tables reach them through the context of the calling thread (current), so that
+ * programs solved in different threads of one process are independent (cf. Solver). A thread uses the
+ * classes of the solver only while it is bound to a context (Scope) ; asperix binds one for the whole
+ * process, and the threads of an evaluation (cf. SccScheduler, ParallelFixpoint) are bound to the
+ * context of the thread that starts them.
+ *
+ * The members are those of a record : each one is read and written by the class it belongs to only.
+ */
+class Context{
+
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        /// the calling thread is bound to a context during the lifetime of a scope
+        class Scope{
+            public:
+                inline Scope(Context& context);
+
+                inline ~Scope();
+
+            protected:
+                Context* _previous;
+        };
+
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+    protected:
+        /// context of the calling thread, NULL if it is not bound
+        static __thread Context* _current;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    public:
+        /// cf. Predicate
+        mapPredicate _mapPredicate;
+        Predicate* _truePredicate;
+        std::vector< std::pair<Predicate*, int> > _trail;
+        std::vector< std::pair<unsigned int, int> > _records;
+        int _stamp;
+        int _stamps;
+
+        /// cf. Dependencies
+        Dependencies* _dependencies;
+
+        /// cf. BuiltInPredicate and BuiltInLiteral
+        std::map<std::string, BuiltInPredicate*> _mapBuiltInPredicate;
+        void* _handle;
+        std::vector<void*> _libs;
+
+        /// cf. Term::factoryMutex and SortedIndex::mutex
+        Mutex _factoryMutex;
+        Mutex _indexMutex;
+
+        /// cf. the factories of terms
+        std::map<std::string, Functor*> _functors;
+        mapNumConst _mapNumConst;
+        mapOperator _mapOperator;
+        arithExprSet _arithExprSet;
+        mapRangeTerm _mapRangeTerm;
+        Functor* _listFunctor;
+        List* _emptyList;
+        int _maxInt;
+        int _maxDepth;
+        int _nextNumber;
+
+        /// cf. Rule and Body
+        int _created;
+        bool _costBasedOrder;
+
+        /// cf. LeapfrogJoin
+        bool _joinEnabled;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+        /// an empty context (limits of the terms : -N 1024, depth 16 ; bodies ordered by costs, leapfrog joins)
+        Context();
+
+    private:
+        /// not copyable
+        Context(const Context&);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+    public:
+        /// delete the predicates and the terms left by the program of the context
+        ~Context();
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+        /// context of the calling thread (it must be bound to one)
+        static inline Context* current();
+
+
+}; // class Context
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline Context::Scope::Scope(Context& context) : _previous(_current){
+    _current = &context;
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+inline Context::Scope::~Scope(){
+    _current = _previous;
+}
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline Context* Context::current(){
+    return _current;
+}
+
+
+
+#endif // _CONTEXT_HPP_
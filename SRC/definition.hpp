@@ -28,6 +28,7 @@
 #include <stack>
 #include <string>
 #include <vector>
+#include <tr1/unordered_map>
 
 #include "exceptions.hpp"
 
@@ -69,6 +70,12 @@ typedef std::set<Variable*> variableSet;
 typedef std::set<ArithExpr*> arithExprSet;
 typedef std::set<std::string> stringSet;
 
+typedef std::vector<int> intVector;
+/// decisions of the answer set search (by rank, in increasing order) from which an atom is derived (cf. Dependencies)
+typedef std::vector<int> decisionSet;
+/// for an argument position of a predicate : tuple indexes (in increasing order) having a given ground term at this position
+typedef std::tr1::unordered_map<Term*, intVector> termIndexMap;
+
 typedef std::pair<Predicate*,int> atomType;
 typedef std::queue<atomType> atomsQueue;
 
@@ -0,0 +1,232 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+#include <iterator>
+
+#include "dependencies.hpp"
+#include "rule.hpp"
+
+
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+const decisionSet Dependencies::_unknown;
+
+const decisionSet* const Dependencies::UNKNOWN = &Dependencies::_unknown;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+// atoms added out of any scope can't be attributed to decisions
+Dependencies::Dependencies()
+ : _enabled(false), _context(UNKNOWN), _deciding(false), _decisions(), _sets(), _records(), _reason(), _knownReason(false), _conflict(), _knownConflict(false){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+Dependencies::~Dependencies(){
+    for (std::vector<decisionSet*>::iterator it = _sets.begin(); it != _sets.end(); ++it)
+        delete *it;
+}
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+// union of a and b : NULL is the empty set, and UNKNOWN absorbs any set
+// a new set is created only if neither a nor b contains the other one
+const decisionSet* Dependencies::merge(const decisionSet* a, const decisionSet* b){
+    if ((a == b) || !b)
+        return a;
+    if (!a)
+        return b;
+    if ((a == UNKNOWN) || (b == UNKNOWN))
+        return UNKNOWN;
+    if (std::includes(a->begin(), a->end(), b->begin(), b->end()))
+        return a;
+    if (std::includes(b->begin(), b->end(), a->begin(), a->end()))
+        return b;
+    decisionSet* ds = new decisionSet();
+    ds->reserve(a->size() + b->size());
+    std::set_union(a->begin(), a->end(), b->begin(), b->end(), std::back_inserter(*ds));
+    state()._sets.push_back(ds);
+    return ds;
+}
+
+
+// the atoms added in a DecisionScope are then the atoms of the new decision
+// the body+ of the rule is matched by the instance
+const decisionSet* Dependencies::decide(int level, Rule* rule, const decisionSet* support){
+    Dependencies& s = state();
+    if (!s._enabled)
+        return NULL;
+    decisionSet* self = new decisionSet(1, s._decisions.size());
+    s._sets.push_back(self);
+    Decision d;
+    d._level = level;
+    d._rule = rule;
+    d._support = support;
+    d._self = self;
+    d._head = -1;
+    d._knownBody = rule->getBodyPlus()->getAtoms(d._body);
+    s._decisions.push_back(d);
+    return self;
+}
+
+
+void Dependencies::cancel(){
+    Dependencies& s = state();
+    if (tracking() && s._decisions.back()._atoms.empty())
+        s._decisions.pop_back();
+}
+
+
+// ds is UNKNOWN when the contradiction can't be attributed to decisions
+ContradictoryConclusion Dependencies::contradiction(const decisionSet* ds){
+    if (tracking() && (ds != UNKNOWN))
+        return ContradictoryConclusion(ds);
+    else
+        return ContradictoryConclusion();
+}
+
+
+// the rule instance of the last decision d is supported by d._support ;
+// when its body- is excluded from the model, the decisions of c lead to contradiction,
+// so the body- can't be excluded as soon as d._support and the other decisions of c hold
+void Dependencies::refute(const ContradictoryConclusion& c){
+    Dependencies& s = state();
+    s._reason.clear();
+    s._knownReason = tracking() && c.knownDecisions();
+    if (s._knownReason) {
+        const Decision& d = s._decisions.back();
+        if (d._support == UNKNOWN)
+            s._knownReason = false;
+        else {
+            int rank = s._decisions.size() - 1;
+            const decisionSet* ds = c.getDecisions();
+            if (ds)
+                for (decisionSet::const_iterator it = ds->begin(); it != ds->end(); ++it)
+                    if (*it != rank)
+                        s._reason.push_back(*it);
+            if (d._support) {
+                decisionSet previous;
+                previous.swap(s._reason);
+                std::set_union(previous.begin(), previous.end(), d._support->begin(), d._support->end(), std::back_inserter(s._reason));
+            }
+        }
+    }
+}
+
+
+// the reason is used once : a later prohibition has its own reason
+const decisionSet* Dependencies::takeReason(){
+    Dependencies& s = state();
+    if (!tracking())
+        return NULL;
+    const decisionSet* ds = UNKNOWN;
+    if (s._knownReason && !s._reason.empty()) {
+        decisionSet* reason = new decisionSet(s._reason);
+        s._sets.push_back(reason);
+        ds = reason;
+    }
+    else if (s._knownReason)
+        ds = NULL;
+    s._knownReason = false;
+    return ds;
+}
+
+
+// the decisions of c are copied : c may be restored before its conflict is used
+void Dependencies::setConflict(const ContradictoryConclusion& c){
+    Dependencies& s = state();
+    decisionSet conflict;
+    s._knownConflict = tracking() && c.knownDecisions();
+    if (s._knownConflict && c.getDecisions())
+        conflict = *c.getDecisions();
+    s._conflict.swap(conflict);
+}
+
+
+ContradictoryConclusion Dependencies::conflict(){
+    Dependencies& s = state();
+    if (!s._knownConflict)
+        return ContradictoryConclusion();
+    return ContradictoryConclusion(&s._conflict);
+}
+
+
+int Dependencies::conflictLevel(){
+    Dependencies& s = state();
+    return s._conflict.empty() ? -1 : s._decisions[s._conflict.back()]._level;
+}
+
+
+const decisionSet* Dependencies::copy(const decisionSet* ds){
+    return ((ds == NULL) || (ds == UNKNOWN)) ? ds : new decisionSet(*ds);
+}
+
+
+void Dependencies::recordState(){
+    Dependencies& s = state();
+    s._records.push_back(std::make_pair(s._sets.size(), s._decisions.size()));
+}
+
+
+void Dependencies::restoreState(unsigned int n){
+    Dependencies& s = state();
+    s._records.resize(s._records.size() - (n - 1));
+    restoreStateWithoutPop();
+    s._records.pop_back();
+}
+
+
+// the sets and decisions created since the last recorded state are forgotten
+void Dependencies::restoreStateWithoutPop(){
+    Dependencies& s = state();
+    unsigned int size = s._records.back().first;
+    while (s._sets.size() > size) {
+        delete s._sets.back();
+        s._sets.pop_back();
+    }
+    s._decisions.resize(std::min<size_t>(s._decisions.size(), s._records.back().second));
+}
+
+
+void Dependencies::updateState(){
+    Dependencies& s = state();
+    s._records.back() = std::make_pair(s._sets.size(), s._decisions.size());
+}
+
+
+void Dependencies::clear(){
+    Dependencies& s = state();
+    for (std::vector<decisionSet*>::iterator it = s._sets.begin(); it != s._sets.end(); ++it)
+        delete *it;
+    s._sets.clear();
+    s._decisions.clear();
+    s._records.clear();
+    s._context = UNKNOWN;
+    s._deciding = false;
+    s._reason.clear();
+    s._knownReason = false;
+    s._conflict.clear();
+    s._knownConflict = false;
+}
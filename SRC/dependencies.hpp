@@ -0,0 +1,332 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _DEPENDENCIES_HPP_
+#define _DEPENDENCIES_HPP_
+
+#include <vector>
+
+#include "context.hpp"
+#include "definition.hpp"
+#include "exceptions.hpp"
+
+
+
+/**
+ * Dependencies of the atoms on the decisions of the answer set search.
+ * A decision is the application of an instance of a non definite rule : its head is added
+ * to the model and its body- is excluded from it. Each atom of an extension is given the set of
+ * decisions from which it has been derived (cf. Predicate::getDependencies) : NULL for the empty
+ * set, UNKNOWN when the derivation can't be attributed to decisions (closed world assumption on
+ * a solved predicate, prohibition after a failed subtree...).
+ * A contradictory conclusion then carries the decisions that lead to it (cf. Nogoods).
+ * Decisions and merged sets are recorded and restored with the extensions of predicates.
+ * The state of the decisions is an instance of Dependencies for each context (cf. Context), the
+ * functions being those of the current context.
+ */
+class Dependencies{
+
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        /// an applied instance of a non definite rule
+        class Decision{
+            public:
+                /// depth of the back-track stack when the decision was made
+                int _level;
+
+                /// non definite rule of the instance
+                Rule* _rule;
+
+                /// decisions from which the body+ of the rule instance is derived
+                const decisionSet* _support;
+
+                /// singleton set of this decision
+                const decisionSet* _self;
+
+                /// atoms added by the decision (head and body- non-instances)
+                std::vector<atomType> _atoms;
+
+                /// number of atoms of the head in _atoms, -1 until the head is added
+                int _head;
+
+                /// atoms of the body+ of the rule instance, from which its head is derived (cf. Nogoods::learn)
+                std::vector<atomType> _body;
+
+                /// false if an atom of the body+ has no index in its extension : _body is then incomplete
+                bool _knownBody;
+        };
+
+        /// atoms added during the lifetime of a scope depend on its decisions
+        class Scope{
+            public:
+                inline Scope(const decisionSet* ds);
+
+                inline ~Scope();
+
+            protected:
+                const decisionSet* _previous;
+        };
+
+        /// atoms added during the lifetime of a decision scope are the atoms of the last decision
+        class DecisionScope : public Scope{
+            public:
+                inline DecisionScope();
+
+                inline ~DecisionScope();
+        };
+
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+    public:
+        static const decisionSet* const UNKNOWN;
+
+    protected:
+        static const decisionSet _unknown;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        /// false if decisions are not tracked (cf. Nogoods)
+        bool _enabled;
+
+        /// dependencies of the atoms being added
+        const decisionSet* _context;
+
+        /// true in a decision scope
+        bool _deciding;
+
+        /// current decisions, by rank
+        std::vector<Decision> _decisions;
+
+        /// sets created by merge
+        std::vector<decisionSet*> _sets;
+
+        /// recorded states : number of sets and number of decisions
+        std::vector< std::pair<unsigned int, unsigned int> > _records;
+
+        /// decisions from which the last refuted decision can't be applied (cf. refute)
+        decisionSet _reason;
+
+        bool _knownReason;
+
+        /// decisions that lead to the last failure of the search (cf. setConflict)
+        decisionSet _conflict;
+
+        bool _knownConflict;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        /// no decision (cf. Context)
+        Dependencies();
+
+    private:
+        /// not copyable
+        Dependencies(const Dependencies&);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+    public:
+        ~Dependencies();
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+    protected:
+        /// decisions of the current context
+        static inline Dependencies& state();
+
+    public:
+        static inline void setEnabled(bool b);
+
+        static inline bool isEnabled();
+
+        /// true if atoms may depend on some decision
+        static inline bool tracking();
+
+        /// dependencies of the atoms being added
+        static inline const decisionSet* current();
+
+        /// dependencies of a derivation that can't be attributed to decisions (closed world assumption...)
+        static inline const decisionSet* unknown();
+
+        static inline const Decision& getDecision(int rank);
+
+        /// atom p_i has been added : it belongs to the current decision, if any
+        static inline void added(Predicate* p, int i);
+
+        /// union of a and b
+        static const decisionSet* merge(const decisionSet* a, const decisionSet* b);
+
+        /// new decision made at level by an instance of rule with support, return its singleton set
+        static const decisionSet* decide(int level, Rule* rule, const decisionSet* support);
+
+        /// the head of the last decision has been added : the next atoms of the decision are its body-
+        static inline void headAdded();
+
+        /// singleton set of the last decision
+        static inline const decisionSet* lastDecision();
+
+        /// forget the last decision if it has added no atom
+        static void cancel();
+
+        /// contradictory conclusion following from the decisions of ds
+        static ContradictoryConclusion contradiction(const decisionSet* ds);
+
+        /// the last decision leads to contradiction c : compute the reason of its prohibition
+        static void refute(const ContradictoryConclusion& c);
+
+        /// reason of the prohibition of the last refuted decision (UNKNOWN if there is none)
+        static const decisionSet* takeReason();
+
+        /// the search fails with contradiction c
+        static void setConflict(const ContradictoryConclusion& c);
+
+        /// contradictory conclusion of the last failure
+        static ContradictoryConclusion conflict();
+
+        /// true if the decisions that lead to the last failure are known
+        static inline bool knownConflict();
+
+        /// level of the deepest decision of the last known conflict, -1 if it follows from no decision
+        static int conflictLevel();
+
+        /// copy of ds that is not restored with the extensions
+        static const decisionSet* copy(const decisionSet* ds);
+
+        /// free a copy
+        static inline void release(const decisionSet* ds);
+
+        static void recordState();
+
+        /// restore the state recorded n states ago, and forget the n last states
+        static void restoreState(unsigned int n = 1);
+
+        static void restoreStateWithoutPop();
+
+        static void updateState();
+
+        /// forget the decisions and the states of the search of a deleted program
+        static void clear();
+
+
+}; // class Dependencies
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline Dependencies::Scope::Scope(const decisionSet* ds) : _previous(state()._context){
+    state()._context = ds;
+}
+
+
+inline Dependencies::DecisionScope::DecisionScope() : Scope(lastDecision()){
+    state()._deciding = tracking();
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+inline Dependencies::Scope::~Scope(){
+    state()._context = _previous;
+}
+
+
+inline Dependencies::DecisionScope::~DecisionScope(){
+    state()._deciding = false;
+}
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline Dependencies& Dependencies::state(){
+    return *Context::current()->_dependencies;
+}
+
+
+inline void Dependencies::setEnabled(bool b){
+    state()._enabled = b;
+}
+
+
+inline bool Dependencies::isEnabled(){
+    return state()._enabled;
+}
+
+
+inline bool Dependencies::tracking(){
+    Dependencies& d = state();
+    return d._enabled && !d._decisions.empty();
+}
+
+
+inline const decisionSet* Dependencies::current(){
+    return tracking() ? state()._context : NULL;
+}
+
+
+inline const decisionSet* Dependencies::unknown(){
+    return tracking() ? UNKNOWN : NULL;
+}
+
+
+inline const Dependencies::Decision& Dependencies::getDecision(int rank){
+    return state()._decisions[rank];
+}
+
+
+inline void Dependencies::added(Predicate* p, int i){
+    Dependencies& d = state();
+    if (d._deciding)
+        d._decisions.back()._atoms.push_back(std::make_pair(p, i));
+}
+
+
+inline void Dependencies::headAdded(){
+    if (tracking()) {
+        Decision& d = state()._decisions.back();
+        d._head = d._atoms.size();
+    }
+}
+
+
+inline const decisionSet* Dependencies::lastDecision(){
+    return tracking() ? state()._decisions.back()._self : NULL;
+}
+
+
+inline bool Dependencies::knownConflict(){
+    return state()._knownConflict;
+}
+
+
+inline void Dependencies::release(const decisionSet* ds){
+    if (ds != UNKNOWN)
+        delete ds;
+}
+
+
+
+#endif // _DEPENDENCIES_HPP_
@@ -24,6 +24,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 
 
@@ -82,7 +83,20 @@ class OutOfRangeFuncTerm : public OutOfRange{
 
 class ContradictoryConclusion : public LogicExcept{
     public:
-        ContradictoryConclusion(const std::string& what = "") : LogicExcept(what){}
+        /// the decisions that lead to the contradiction are unknown
+        ContradictoryConclusion(const std::string& what = "") : LogicExcept(what), _decisions(NULL), _known(false){}
+
+        /// the contradiction follows from the decisions of ds (NULL if it follows from no decision)
+        ContradictoryConclusion(const std::vector<int>* ds) : LogicExcept(""), _decisions(ds), _known(true){}
+
+        bool knownDecisions() const{ return _known; }
+
+        const std::vector<int>* getDecisions() const{ return _decisions; }
+
+    protected:
+        const std::vector<int>* _decisions;
+
+        bool _known;
 
 }; // class ContradictoryConclusion
 
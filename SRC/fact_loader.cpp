@@ -0,0 +1,313 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fact_loader.hpp"
+#include "func_term.hpp"
+#include "num_const.hpp"
+#include "predicate.hpp"
+#include "search_control.hpp"
+#include "symb_const.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+FactLoader::FactLoader(Graph& g) : _graph(g), _file(), _line(0), _facts(0), _time(0), _constants(), _pred(NULL), _pred_name(), _arity(0), _name(), _tuple(){}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+int FactLoader::load(const std::string& fileName){
+    double start = SearchControl::now();
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw RuntimeExcept("can not open `" + fileName + "`");
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw RuntimeExcept("can not read `" + fileName + "`");
+    }
+    size_t size = st.st_size;
+    void* data = NULL;
+    if (size > 0) {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw RuntimeExcept("can not map `" + fileName + "` in memory");
+        }
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    _file = fileName;
+    _line = 0;
+    int facts = _facts;
+    try {
+        const char* pos = static_cast<const char*>(data);
+        const char* end = pos + size;
+        while (pos < end) {
+            const char* eol = static_cast<const char*>(memchr(pos, '\n', end - pos));
+            if (!eol)
+                eol = end;
+            ++_line;
+            loadLine(pos, eol);
+            pos = eol + 1;
+        }
+    }
+    catch (...) {
+        if (data)
+            munmap(data, size);
+        throw;
+    }
+    if (data)
+        munmap(data, size);
+    _time += SearchControl::now() - start;
+    return _facts - facts;
+}
+
+
+void FactLoader::add(const std::string& fact){
+    _file.clear();
+    loadLine(fact.data(), fact.data() + fact.size());
+}
+
+
+void FactLoader::add(const std::string& name, const std::vector<std::string>& fields){
+    _file.clear();
+    std::string::size_type first = (!name.empty() && (name[0] == '-')) ? 1 : 0;
+    if ((first == name.size()) || !islower(name[first]))
+        throw error("predicate name expected");
+    for (std::string::size_type i = first; i < name.size(); ++i)
+        if (!isalnum(name[i]) && (name[i] != '_'))
+            throw error("predicate name expected");
+    _name = name;
+    _tuple.clear();
+    for (std::vector<std::string>::const_iterator it = fields.begin(); it != fields.end(); ++it)
+        _tuple.push_back(readField(it->data(), it->data() + it->size()));
+    setPredicate();
+    _pred->addTrueInstance(_tuple);
+    ++_facts;
+}
+
+
+void FactLoader::loadLine(const char* begin, const char* end){
+    while ((begin < end) && ((*begin == ' ') || (*begin == '\t')))
+        ++begin;
+    while ((end > begin) && isspace(end[-1]))   // '\r' of DOS files
+        --end;
+    if ((begin == end) || (*begin == '%'))
+        return;
+
+    const char* pos = begin;
+    if (*pos == '-')    // classical negation
+        ++pos;
+    if ((pos == end) || !islower(*pos))
+        throw error("predicate name expected");
+    while ((pos < end) && (isalnum(*pos) || (*pos == '_')))
+        ++pos;
+    _name.assign(begin, pos);
+    _tuple.clear();
+
+    if ((pos < end) && ((*pos == '\t') || (*pos == ','))) {    // table
+        char sep = *pos;
+        while (pos < end) {     // pos is on a separator
+            const char* field = ++pos;
+            while ((pos < end) && (*pos == ' '))
+                ++pos;
+            if ((sep == ',') && (pos < end) && (*pos == '"')) {    // a quoted field may contain commas
+                const char* quote = static_cast<const char*>(memchr(pos + 1, '"', end - pos - 1));
+                if (!quote)
+                    throw error("unterminated string");
+                pos = quote + 1;
+            }
+            while ((pos < end) && (*pos != sep))
+                ++pos;
+            _tuple.push_back(readField(field, pos));
+        }
+    }
+    else {  // as in a program
+        while ((pos < end) && (*pos == ' '))
+            ++pos;
+        if ((pos < end) && (*pos == '(')) {
+            do {
+                ++pos;
+                _tuple.push_back(readTerm(pos, end));
+            } while ((pos < end) && (*pos == ','));
+            if ((pos == end) || (*pos != ')'))
+                throw error("`)' expected");
+            ++pos;
+            while ((pos < end) && (*pos == ' '))
+                ++pos;
+        }
+        if ((pos < end) && (*pos == '.'))
+            ++pos;
+        while ((pos < end) && isspace(*pos))
+            ++pos;
+        if ((pos < end) && (*pos != '%'))
+            throw error("unexpected `" + std::string(pos, end) + "' (only ground facts can be loaded)");
+    }
+
+    setPredicate();
+    _pred->addTrueInstance(_tuple);
+    ++_facts;
+}
+
+
+// spaces around the term are skipped
+Term* FactLoader::readTerm(const char*& pos, const char* end){
+    while ((pos < end) && (*pos == ' '))
+        ++pos;
+    const char* begin = pos;
+    Term* t = NULL;
+    if ((pos < end) && (*pos == '"')) {
+        const char* quote = (pos + 1 < end) ? static_cast<const char*>(memchr(pos + 1, '"', end - pos - 1)) : NULL;
+        if (!quote)
+            throw error("unterminated string");
+        pos = quote + 1;
+        t = constant(std::string(begin, pos));
+    }
+    else if ((pos < end) && ((*pos == '-') || isdigit(*pos))) {
+        ++pos;
+        while ((pos < end) && isdigit(*pos))
+            ++pos;
+        t = constant(std::string(begin, pos));
+    }
+    else if ((pos < end) && islower(*pos)) {
+        while ((pos < end) && (isalnum(*pos) || (*pos == '_')))
+            ++pos;
+        std::string name(begin, pos);
+        while ((pos < end) && (*pos == ' '))
+            ++pos;
+        if ((pos < end) && (*pos == '(')) {     // functional term
+            Argument* args = new Argument();
+            try {
+                do {
+                    ++pos;
+                    args->push_back(readTerm(pos, end));
+                } while ((pos < end) && (*pos == ','));
+                if ((pos == end) || (*pos != ')'))
+                    throw error("`)' expected");
+                ++pos;
+                t = FuncTerm::new_FuncTerm(name, args);
+            }
+            catch (const OutOfRangeFuncTerm&) {
+                delete args;
+                throw error("too deep functional term");
+            }
+            catch (const RuntimeExcept&) {
+                delete args;
+                throw;
+            }
+        }
+        else
+            t = constant(name);
+    }
+    if (!t)
+        throw error("ground term expected");
+    while ((pos < end) && (*pos == ' '))
+        ++pos;
+    return t;
+}
+
+
+Term* FactLoader::readField(const char* begin, const char* end){
+    while ((begin < end) && (*begin == ' '))
+        ++begin;
+    while ((end > begin) && (end[-1] == ' '))
+        --end;
+    std::string s(begin, end);
+    Term* t = constant(s);
+    if (!t) {
+        if (s.find('"') != std::string::npos)
+            throw error("bad field `" + s + "'");
+        t = constant('"' + s + '"');
+    }
+    return t;
+}
+
+
+Term* FactLoader::constant(const std::string& s){
+    std::tr1::unordered_map<std::string, Term*>::const_iterator it = _constants.find(s);
+    if (it != _constants.end())
+        return it->second;
+
+    Term* t = NULL;
+    size_t n = s.size();
+    if (n == 0)
+        return NULL;
+    else if ((s[0] == '"') && (n > 1) && (s[n - 1] == '"') && (s.find('"', 1) == n - 1))
+        t = SymbConst::new_SymbConst(s);
+    else if (islower(s[0])) {
+        for (size_t i = 1; i < n; ++i)
+            if (!isalnum(s[i]) && (s[i] != '_'))
+                return NULL;
+        t = SymbConst::new_SymbConst(s);
+    }
+    else if (isdigit(s[0]) || ((s[0] == '-') && (n > 1))) {
+        for (size_t i = 1; i < n; ++i)
+            if (!isdigit(s[i]))
+                return NULL;
+        errno = 0;
+        long v = strtol(s.c_str(), NULL, 10);
+        try {
+            if ((errno == ERANGE) || (v > INT_MAX) || (v < -INT_MAX))
+                throw OutOfRangeNumConst();
+            t = NumConst::new_NumConst(v);
+        }
+        catch (const OutOfRangeNumConst&) {
+            throw error("out of range numeric constant " + s);
+        }
+    }
+    else
+        return NULL;
+    _constants.insert(std::make_pair(s, t));
+    return t;
+}
+
+
+void FactLoader::setPredicate(){
+    int arity = _tuple.size();
+    if (!_pred || (arity != _arity) || (_name != _pred_name)) {
+        _pred = Predicate::newPredicate(_name, arity, _graph);
+        _pred_name = _name;
+        _arity = arity;
+    }
+}
+
+
+RuntimeExcept FactLoader::error(const std::string& mess) const{
+    std::ostringstream oss;
+    oss << mess;
+    if (!_file.empty())     // a file being loaded (cf. add)
+        oss << " (" << _file << ", line " << _line << ')';
+    return RuntimeExcept(oss.str());
+}
@@ -0,0 +1,143 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _FACT_LOADER_HPP_
+#define _FACT_LOADER_HPP_
+
+#include <string>
+#include <tr1/unordered_map>
+#include <vector>
+
+#include "arguments.hpp"
+#include "definition.hpp"
+#include "exceptions.hpp"
+#include "graph.hpp"
+
+class Predicate;
+
+
+
+/**
+ * FactLoader reads files of ground facts (option -facts or directive #facts) without the parser :
+ * the file is mapped in memory and each tuple is added to the extension of its predicate, as a
+ * fact rule would do, but without building the rule.
+ *
+ * Each line of the file is one fact, written either
+ *  - as in a program, "p(a,1,f(b))." or "p." (the final dot is optional), or
+ *  - as fields separated by tabulations or by commas, the first one being the name of the predicate :
+ *    "p<TAB>a<TAB>1" or "p,a,1". A field which is neither a number, a symbolic constant nor a quoted
+ *    string is read as a quoted string ("New York" for New York), so that any table can be loaded.
+ * Empty lines and lines beginning with % are ignored.
+ */
+class FactLoader{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        Graph& _graph;
+
+        /// name of the file being loaded, and current line
+        std::string _file;
+        int _line;
+
+        /// number of facts read (from all files)
+        int _facts;
+
+        /// seconds spent loading (all files)
+        double _time;
+
+        /// constants already read, by text (constants repeat a lot in a table)
+        std::tr1::unordered_map<std::string, Term*> _constants;
+
+        /// predicate of the previous fact, with its name and arity
+        Predicate* _pred;
+        std::string _pred_name;
+        int _arity;
+
+        /// name and tuple of the current fact
+        std::string _name;
+        Argument _tuple;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        FactLoader(Graph& g);
+
+
+//********************************** GETTERS *********************************//
+
+        inline int getFacts() const;
+
+        /// facts loaded by second (0 if nothing was loaded)
+        inline double getRate() const;
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// add the facts of file fileName to the extensions and return their number
+        /// throw RuntimeExcept if the file can not be read or a line is malformed
+        int load(const std::string& fileName);
+
+        /// add the fact of line fact, written as a line of a file
+        /// throw RuntimeExcept if it is malformed
+        void add(const std::string& fact);
+
+        /// add the fact name(fields), each field being read as a field of a table
+        /// throw RuntimeExcept if name is not the name of a predicate
+        void add(const std::string& name, const std::vector<std::string>& fields);
+
+    protected:
+        /// read the fact of the line [begin, end)
+        void loadLine(const char* begin, const char* end);
+
+        /// read a ground term written as in a program from pos, and move pos after it
+        Term* readTerm(const char*& pos, const char* end);
+
+        /// constant written [begin, end) in a field of a table
+        Term* readField(const char* begin, const char* end);
+
+        /// constant of text s, NULL if s is not a number, a symbolic constant or a quoted string
+        Term* constant(const std::string& s);
+
+        /// set _pred to the predicate of the current fact
+        void setPredicate();
+
+        RuntimeExcept error(const std::string& mess) const;
+
+
+}; // class FactLoader
+
+
+//********************************** GETTERS *********************************//
+
+inline int FactLoader::getFacts() const{
+    return _facts;
+}
+
+
+inline double FactLoader::getRate() const{
+    return (_time > 0) ? _facts / _time : 0;
+}
+
+
+
+#endif // _FACT_LOADER_HPP_
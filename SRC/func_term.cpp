@@ -24,12 +24,6 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-// default value
-int FuncTerm::_maxDepth = 16;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 // WARNING : a is deleted if already exists
@@ -42,6 +36,7 @@ FuncTerm* FuncTerm::new_FuncTerm(const std::string& s, Argument* a){
 
 // WARNING : a is deleted if already exists
 FuncTerm* FuncTerm::new_FuncTerm(Functor* f, Argument* a){
+    MutexLock lock(factoryMutex());
     FuncTerm* t;
     variableSet* vars = new variableSet;
     a->addVariables(*vars); // each term adds its own variables to vars set
@@ -51,7 +46,7 @@ FuncTerm* FuncTerm::new_FuncTerm(Functor* f, Argument* a){
     }
     else {  // term with vars or first occurence of term
         int depth = a->getMaxDepth() + 1;   //depth of the deepest term
-        if (depth <= _maxDepth) {
+        if (depth <= _maxDepth()) {
             t = new FuncTerm(f, a, vars, depth);
             if (vars->empty())
                 f->insertGroundTerm(*a, t);
@@ -70,7 +65,7 @@ FuncTerm* FuncTerm::new_FuncTerm(Functor* f, Argument* a){
 //******************************* CONSTRUCTORS *******************************//
 
 FuncTerm::FuncTerm(Functor* f, Argument* tv, variableSet* vs, int d)
- : _functor(f), _args(tv), _variables(vs), _depth(d){}
+ : _functor(f), _args(tv), _variables(vs), _depth(d), _ground_args(NULL){}
 
 
 //******************************** DESTRUCTOR ********************************//
@@ -78,6 +73,7 @@ FuncTerm::FuncTerm(Functor* f, Argument* tv, variableSet* vs, int d)
 FuncTerm::~FuncTerm(){
     delete _args;
     delete _variables;
+    delete _ground_args;
 }
 
 
@@ -96,6 +92,22 @@ Term* FuncTerm::applySubstitution(){
 }
 
 
+// a term that does not exist is in no tuple ; as for applySubstitution, a too deep term is out of range
+Term* FuncTerm::findSubstitution(){
+    if (_variables->empty())
+        return this;
+    if (!_ground_args)
+        _ground_args = new Argument();
+    if (!_args->findSubstitution(*_ground_args))
+        return NULL;
+    MutexLock lock(factoryMutex());
+    Term* t = _functor->existGroundTerm(*_ground_args);
+    if (!t && (_ground_args->getMaxDepth() + 1 > _maxDepth()))
+        throw OutOfRangeFuncTerm();
+    return t;
+}
+
+
 // t is a ground term
 bool FuncTerm::match(Term* t){
     if ( !t->isFuncTerm() || (_functor != t->getFunctor()) )
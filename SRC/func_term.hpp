@@ -26,6 +26,7 @@
 #include <string>
 
 #include "arguments.hpp"
+#include "context.hpp"
 #include "functor.hpp"
 #include "term.hpp"
 #include "variable.hpp"
@@ -44,7 +45,7 @@ class FuncTerm : public Term{
 //************************** STATIC MEMBER VARIABLES *************************//
 
     protected:
-        static int _maxDepth;
+        static inline int& _maxDepth();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -63,6 +64,9 @@ class FuncTerm : public Term{
         /// length of the longest branch
         int _depth;
 
+        /// substituted arguments of a term with variables (cf. findSubstitution), NULL until it is needed
+        Argument* _ground_args;
+
 
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
@@ -73,6 +77,8 @@ class FuncTerm : public Term{
 
         static inline void setMaxDepth(int n);
 
+        static inline int getMaxDepth();
+
 
 //******************************* CONSTRUCTORS *******************************//
 
@@ -114,6 +120,9 @@ class FuncTerm : public Term{
 
         Term* applySubstitution();
 
+        /// the substituted arguments are built in _ground_args, and the ground term looked up in the functor
+        Term* findSubstitution();
+
         /// free all variables of _free_vars
         inline void free();
 
@@ -128,8 +137,18 @@ class FuncTerm : public Term{
 
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
+inline int& FuncTerm::_maxDepth(){
+    return Context::current()->_maxDepth;
+}
+
+
 inline void FuncTerm::setMaxDepth(int n){
-    _maxDepth = n;
+    _maxDepth() = n;
+}
+
+
+inline int FuncTerm::getMaxDepth(){
+    return _maxDepth();
 }
 
 
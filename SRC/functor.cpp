@@ -33,6 +33,7 @@
  * Returns the address of the underlying functor
  */
 Functor* Functor::newFunctor(const std::string& name, int arity){
+    MutexLock lock(Term::factoryMutex());
     std::ostringstream oss;
     oss << name << '/' << arity;    // cast int2string
     std::string s = oss.str();
@@ -27,6 +27,7 @@
 #include <string>
 
 #include "arguments.hpp"
+#include "context.hpp"
 
 
 
@@ -72,13 +73,12 @@ class Functor{
 
     private:
         /**
-         * @brief Container that stores all the functors.
+         * @brief Container that stores all the functors of the current context.
          * 
-         * @sa newFunctor(const std::string&, int), deleteAll()
+         * @sa newFunctor(const std::string&, int), deleteAll(), Context
          */
         static Map& _functors(){
-            static Map functors;
-            return functors;
+            return Context::current()->_functors;
         }
 
 
@@ -35,7 +35,7 @@
 
 //******************************* CONSTRUCTORS *******************************//
 
-Node::Node(Predicate* p) : _pred(p), _visited(0), _onStack(false){}
+Node::Node(Predicate* p, int number) : _pred(p), _number(number), _sccIndex(-1){}
 
 
 //******************************** DESTRUCTOR ********************************//
@@ -55,34 +55,21 @@ std::ostream& operator << (std::ostream& os,Node& n){
 
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
-void Node::tarjan(Graph& graph){
-    _visited = graph.nextDate();
-    _lowLink = _visited;
-    _onStack = true;
-    graph.pushStack(this);
-
-    visitSuccessors(_posSucc, graph);
-    visitSuccessors(_negSucc, graph);
-    if (_lowLink == _visited) { // the node is the root of a scc 
-                                //nodes are in the stack from top to (*this)
-        Node* n;
-        do {
-            n = graph.topStack();
-            graph.popStack();
-            n->setOutStack();
-            graph.addNode2scc(n);
-        } while (n != this);
-        graph.saveAndClearSCC();
-    }
-}
-
-
-void Node::visitSuccessors(Node::Set& succ, Graph& graph){
-    for (Node::Set::iterator it = succ.begin(); it !=succ.end(); it++) {
-        if (!(*it)->_visited)   // arc couvrant
-            (*it)->tarjan(graph);
-        if ((*it)->_onStack)    // arc arrière 
-            _lowLink = std::min(_lowLink,(*it)->_lowLink); 
+// successors are sorted by number, not by address : the order of the visit does not depend on memory allocation
+void Node::compactSuccessors(){
+    Node::Vector* succ[2] = {&_posSucc, &_negSucc};
+    for (int k = 0; k < 2; ++k) {
+        std::vector< std::pair<int, Node*> > numbered;
+        numbered.reserve(succ[k]->size());
+        for (Node::Vector::iterator i = succ[k]->begin(); i != succ[k]->end(); ++i)
+            numbered.push_back(std::make_pair((*i)->_number, *i));
+        std::sort(numbered.begin(), numbered.end());
+        Node::Vector compacted;
+        compacted.reserve(numbered.size());
+        for (std::vector< std::pair<int, Node*> >::iterator i = numbered.begin(); i != numbered.end(); ++i)
+            if (compacted.empty() || (compacted.back() != i->second))
+                compacted.push_back(i->second);
+        succ[k]->swap(compacted);
     }
 }
 
@@ -128,9 +115,36 @@ void Node::addConstraintsContainingNotP(ruleSet& rset){
 }
 
 
+// add to deps the dependencies between scc due to the node (deps[i] : scc that must be evaluated before scc i)
+// - the scc of a successor is evaluated before (it has a less index)
+// - the scc of the opposite predicate "-p" adds "p" to the non-extension of "-p" and conversely :
+//   it must be evaluated in the same order as the scc of the node, and as the scc of each successor "q"
+//   reading the non-extension of "q" (written by the scc of "-q")
+void Node::addSccDependencies(std::vector< std::set<int> >& deps){
+    Node::Vector* succ[2] = {&_posSucc, &_negSucc};
+    for (int k = 0; k < 2; ++k)
+        for (Node::Vector::iterator i = succ[k]->begin(); i != succ[k]->end(); ++i) {
+            if ((*i)->_sccIndex != _sccIndex)
+                deps.at(_sccIndex).insert((*i)->_sccIndex);
+            if ((*i)->_pred->hasOppositePredicate()) {
+                int opposite = (*i)->_pred->getOppositePredicate()->getNode()->_sccIndex;
+                if (opposite < _sccIndex)
+                    deps.at(_sccIndex).insert(opposite);
+                else if (opposite > _sccIndex)
+                    deps.at(opposite).insert(_sccIndex);
+            }
+        }
+    if (_pred->hasOppositePredicate()) {
+        int opposite = _pred->getOppositePredicate()->getNode()->_sccIndex;
+        if (opposite < _sccIndex)
+            deps.at(_sccIndex).insert(opposite);
+    }
+}
+
+
 // true if all negative successors are outer the scc
 bool Node::isLocallyStratified(int index){
-    Node::Set::iterator i = _negSucc.begin();   // negative successors
+    Node::Vector::iterator i = _negSucc.begin();   // negative successors
     while ((i != _negSucc.end()) && !(*i)->inScc(index))
         ++i;
     return (i == _negSucc.end());
@@ -142,7 +156,7 @@ bool Node::isLocallyStratified(int index){
 //              and, for each arc (p,q) where p inner and q outer the scc, q is solved
 bool Node::checkSolveness(){
     bool solved = true;
-    Node::Set::iterator i = _posSucc.begin();   // positive successors
+    Node::Vector::iterator i = _posSucc.begin();   // positive successors
     while (solved && i != _posSucc.end()) {
         if (!(*i)->inScc(_sccIndex) && !(*i)->isSolved())   // p inner, q outer,and q is not solved
             solved = false;
@@ -171,16 +185,15 @@ bool Node::checkSolveness(){
 
 //******************************* CONSTRUCTORS *******************************//
 
-Graph::Graph() : _date(0){}
+Graph::Graph(){}
 
 
 //******************************** DESTRUCTOR ********************************//
 
 Graph::~Graph(){
-    for (Node::Set::iterator it = _nodes.begin(); it!=_nodes.end(); it++)
+    for (Node::Vector::iterator it = _nodes.begin(); it!=_nodes.end(); it++)
         delete (*it);
     _nodes.clear();
-    _scc.clear();
     _sccVector.clear();
     _non_stratified_sccVector.clear();
 }
@@ -190,16 +203,82 @@ Graph::~Graph(){
 
 // call by p itself when created
 Node* Graph::new_Node(Predicate* p){
-    Node* n = new Node(p);
-    _nodes.insert(n);
+    Node* n = new Node(p, _nodes.size());
+    _nodes.push_back(n);
     return n;
 }
 
 
+// Tarjan's algorithm, without recursion (a program may have very long chains of predicates),
+// over a compact copy of the arcs : the successors of node i are targets[offsets[i]..offsets[i+1][,
+// positive ones first. Nodes and successors are visited by number, so the numbering is deterministic.
 void Graph::computeSCC(){
-    for (Node::Set::iterator it = _nodes.begin(); it != _nodes.end(); it++)
-        if (!(*it)->isVisited())
-            (*it)->tarjan(*this);
+    int size = _nodes.size();
+    intVector offsets(size + 1, 0);
+    for (int i = 0; i < size; ++i) {
+        _nodes[i]->compactSuccessors();
+        offsets[i + 1] = offsets[i] + _nodes[i]->getPosSucc().size() + _nodes[i]->getNegSucc().size();
+    }
+    intVector targets;
+    targets.reserve(offsets[size]);
+    for (int i = 0; i < size; ++i) {
+        Node::Vector& pos = _nodes[i]->getPosSucc();
+        Node::Vector& neg = _nodes[i]->getNegSucc();
+        for (Node::Vector::iterator j = pos.begin(); j != pos.end(); ++j)
+            targets.push_back((*j)->getNumber());
+        for (Node::Vector::iterator j = neg.begin(); j != neg.end(); ++j)
+            targets.push_back((*j)->getNumber());
+    }
+
+    intVector visited(size, 0);     // date of the visit, 0 if the node is not visited
+    intVector lowLink(size, 0);
+    std::vector<bool> onStack(size, false);
+    intVector stack;                // nodes whose scc is not complete
+    std::vector< std::pair<int, int> > path;    // nodes being visited, with their next arc
+    int date = 0;
+    for (int root = 0; root < size; ++root) {
+        if (visited[root])
+            continue;
+        visited[root] = lowLink[root] = ++date;
+        onStack[root] = true;
+        stack.push_back(root);
+        path.push_back(std::make_pair(root, offsets[root]));
+        while (!path.empty()) {
+            int n = path.back().first;
+            if (path.back().second < offsets[n + 1]) {
+                int succ = targets[path.back().second++];
+                if (!visited[succ]) {   // arc couvrant
+                    visited[succ] = lowLink[succ] = ++date;
+                    onStack[succ] = true;
+                    stack.push_back(succ);
+                    path.push_back(std::make_pair(succ, offsets[succ]));
+                }
+                else if (onStack[succ]) // arc arrière
+                    lowLink[n] = std::min(lowLink[n], lowLink[succ]);
+            }
+            else {
+                path.pop_back();
+                if (lowLink[n] == visited[n]) { // the node is the root of a scc
+                                                // nodes are in the stack from top to n
+                    int index = _sccVector.size();
+                    _sccVector.push_back(Node::Set());
+                    int m;
+                    do {
+                        m = stack.back();
+                        stack.pop_back();
+                        onStack[m] = false;
+                        _nodes[m]->setSccIndex(index);
+                        _sccVector.back().insert(_nodes[m]);
+                    } while (m != n);
+                }
+                if (!path.empty() && onStack[n]) {
+                    int parent = path.back().first;
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[n]);
+                }
+            }
+        }
+    }
+    _solved.assign(_sccVector.size(), false);
     initNonStratifiedSccVector();
 }
 
@@ -211,6 +290,22 @@ void Graph::getRulesFromScc(int index, ruleSet& recRules, ruleSet& exitRules, Pr
 }
 
 
+// dependencies between scc (cf. Node::addSccDependencies) : an scc is evaluated after each scc it depends on
+void Graph::getSccDependencies(std::vector<intVector>& dependents, intVector& dependencies){
+    int size = numberOfScc();
+    std::vector< std::set<int> > deps(size);
+    for (Node::Vector::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+        (*i)->addSccDependencies(deps);
+    dependents.assign(size, intVector());
+    dependencies.assign(size, 0);
+    for (int index = 0; index < size; ++index) {
+        for (std::set<int>::iterator i = deps.at(index).begin(); i != deps.at(index).end(); ++i)
+            dependents.at(*i).push_back(index);
+        dependencies.at(index) = deps.at(index).size();
+    }
+}
+
+
 // return true if at least one predicate of the scc has a MBT instance
 bool Graph::existsMbtInstance(int index){
     Node::Set& scc = _sccVector.at(index);
@@ -237,6 +332,13 @@ void Graph::addConstraintsContainingNotP(int index, ruleSet& rset){
 }
 
 
+void Graph::addNegatedPredicates(int index, std::vector<Predicate*>& preds){
+    Node::Set& scc = _sccVector.at(index);
+    for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i)
+        (*i)->addNegatedPredicate(preds);
+}
+
+
 // non solved (non locally stratified) scc are those that contain at least one rule with a literal from body- in the same scc than the head (that is, at least one arc internal to the scc is negative)
 void Graph::initNonStratifiedSccVector(){
     int size = _sccVector.size();
@@ -265,12 +367,12 @@ void Graph::setSolvedIfItIsTheCase(int index){
     while ((i != scc.end()) && (*i)->checkSolveness())
         i++;
     if (i == scc.end()) {   // predicates are solved
-        _solved.push_back(true);
+        _solved.at(index) = true;
         for (i = scc.begin(); i != scc.end(); i++)
             (*i)->setSolved(true);
     }
     else
-        _solved.push_back(false);
+        _solved.at(index) = false;
 }
 
 
@@ -305,46 +407,12 @@ bool Graph::emptyDelta(int index){
 }
 
 
-// record known extensions and non-extensions of (non solved) predicates whose scc is greater or equal than 'sccIndex' (for back-track)
-void Graph::recordExtensions(int sccIndex){
-    int max = numberOfScc();
-    do {    // record extensions and non-extensions of scc corresponding to 'sccIndex'
-        Node::Set& scc = _sccVector.at(sccIndex);
-        for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i)
-            (*i)->recordExtensions();
-    } while (nextNonSolvedScc(sccIndex, max));  // next scc
-}
-
-
-// restore previous extensions and non-extensions of (non solved) predicates whose scc is greater or equal than 'sccIndex' 
-void Graph::restoreExtensions(int sccIndex){
-    int max = numberOfScc();
-    do {    // record extensions and non-extensions of scc corresponding to 'sccIndex'
-        Node::Set& scc = _sccVector.at(sccIndex);
-        for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i)
-            (*i)->restoreExtensions();
-    } while (nextNonSolvedScc(sccIndex, max));  // next scc
-}
-
-
-void Graph::restoreExtensionsWithoutPop(int sccIndex){
-    int max = numberOfScc();
-    do {    // record extensions and non-extensions of scc corresponding to 'sccIndex'
-        Node::Set& scc = _sccVector.at(sccIndex);
-        for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i)
-            (*i)->restoreExtensionsWithoutPop();
-    } while (nextNonSolvedScc(sccIndex, max));  // next scc
-}
-
-
-// update extensions and non-extensions of (non solved) predicates whose scc is greater or equal than 'sccIndex'
-void Graph::updateExtensions(int sccIndex){
-    int max = numberOfScc();
-    do {    // update extensions and non-extensions of scc corresponding to 'sccIndex'
-        Node::Set& scc = _sccVector.at(sccIndex);
-        for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i)
-            (*i)->updateExtensions();
-    } while (nextNonSolvedScc(sccIndex, max));  // next scc
+int Graph::deltaSize(int index){
+    int size = 0;
+    Node::Set& scc = _sccVector.at(index);
+    for (Node::Set::iterator i = scc.begin(); i != scc.end(); i++)
+        size += (*i)->deltaSize();
+    return size;
 }
 
 
@@ -24,7 +24,6 @@
 
 #include <string>
 #include <iostream>
-#include <stack>
 #include <set>
 #include <vector>
 
@@ -57,21 +56,21 @@ class Node{
     public:
         typedef std::set<Node*> Set;
 
+        typedef std::vector<Node*> Vector;
+
 
 //***************************** MEMBERS VARIABLES ****************************//
 
     protected:
         Predicate* _pred;
 
-        Node::Set _posSucc;
-
-        Node::Set _negSucc;
-
-        int _visited;
+        /// creation number of the node (cf. Graph::new_Node)
+        int _number;
 
-        int _lowLink;
+        /// successors, sorted by number without duplicates once compacted (cf. compactSuccessors)
+        Node::Vector _posSucc;
 
-        bool _onStack;
+        Node::Vector _negSucc;
 
         /// index of SCC in which the node is
         int _sccIndex;
@@ -80,7 +79,7 @@ class Node{
 //******************************* CONSTRUCTORS *******************************//
 
     public:
-        Node(Predicate* p);
+        Node(Predicate* p, int number);
 
 
 //******************************** DESTRUCTOR ********************************//
@@ -90,19 +89,19 @@ class Node{
 
 //********************************** GETTERS *********************************//
 
-        inline Node::Set& getPosSucc();
+        inline Predicate* getPred();
 
-        inline Node::Set& getNegSucc();
+        inline Node::Vector& getPosSucc();
 
-        inline bool isVisited();
+        inline Node::Vector& getNegSucc();
+
+        inline int getNumber();
 
         inline int getSccIndex();
 
 
 //********************************** SETTERS *********************************//
 
-        inline void setOutStack();
-
         inline void setSccIndex(int n);
 
 
@@ -119,9 +118,8 @@ class Node{
 
         inline void addNegSucc(Node* n);
 
-        void tarjan(Graph& g);
-
-        void visitSuccessors(Node::Set& succ, Graph& graph);
+        /// sort successors by number and remove duplicate arcs
+        void compactSuccessors();
 
         void addRules(ruleSet& recRules, ruleSet& exitRules, Node::Set& scc, Program& prog);
 
@@ -129,6 +127,11 @@ class Node{
 
         void addConstraintsContainingNotP(ruleSet& rset);
 
+        inline void addNegatedPredicate(std::vector<Predicate*>& preds);
+
+        /// add to deps the dependencies between scc due to the node (deps[i] : scc that must be evaluated before scc i)
+        void addSccDependencies(std::vector< std::set<int> >& deps);
+
         inline bool existsMbtInstance();
 
         /// true if all negative successors are outer the scc
@@ -146,17 +149,10 @@ class Node{
 
         inline bool emptyDelta();
 
-        inline bool inScc(int n);
-
-        /// record known extensions and non-extensions of _pred (for back-track)
-        inline void recordExtensions();
+        /// number of instances in the delta of the predicate
+        inline int deltaSize();
 
-        /// restore previous extensions and non-extensions of _pred
-        inline void restoreExtensions();
-
-        inline void restoreExtensionsWithoutPop();
-
-        inline void updateExtensions();
+        inline bool inScc(int n);
 
 
 }; // class Node
@@ -164,18 +160,23 @@ class Node{
 
 //********************************** GETTERS *********************************//
 
-inline Node::Set& Node::getPosSucc(){
+inline Predicate* Node::getPred(){
+    return _pred;
+}
+
+
+inline Node::Vector& Node::getPosSucc(){
     return _posSucc;
 }
 
 
-inline Node::Set& Node::getNegSucc(){
+inline Node::Vector& Node::getNegSucc(){
     return _negSucc;
 }
 
 
-inline bool Node::isVisited(){
-    return _visited;
+inline int Node::getNumber(){
+    return _number;
 }
 
 
@@ -186,11 +187,6 @@ inline int Node::getSccIndex(){
 
 //********************************** SETTERS *********************************//
 
-inline void Node::setOutStack(){
-    _onStack = false;
-}
-
-
 inline void Node::setSccIndex(int n){
     _sccIndex = n;
 }
@@ -198,17 +194,23 @@ inline void Node::setSccIndex(int n){
 
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
+// duplicate arcs are removed by compactSuccessors
 inline void Node::addPosSucc(Node* n){
-    _posSucc.insert(n);
+    _posSucc.push_back(n);
 }
 
 
 inline void Node::addNegSucc(Node* n){
-    _negSucc.insert(n);
+    _negSucc.push_back(n);
 }
 
 
 // return true if the predicate (label of the node) has an instance with MBT status
+inline void Node::addNegatedPredicate(std::vector<Predicate*>& preds){
+    preds.push_back(_pred->getNegatedPredicate());
+}
+
+
 inline bool Node::existsMbtInstance(){
     return (_pred->getMbtNumber() != 0);
 }
@@ -239,34 +241,13 @@ inline bool Node::emptyDelta(){
 }
 
 
-inline bool Node::inScc(int n){
-    return _sccIndex == n;
-}
-
-
-// record known extensions and non-extensions of _pred (for back-track)
-void Node::recordExtensions(){
-    _pred->recordExtension();
-    _pred->recordNonExtension();
-}
-
-
-// restore previous extensions and non-extensions of _pred
-void Node::restoreExtensions(){
-    _pred->restoreExtension();
-    _pred->restoreNonExtension();
+inline int Node::deltaSize(){
+    return _pred->getDeltaEndIndex() - _pred->getDeltaBeginIndex() + 1;
 }
 
 
-void Node::restoreExtensionsWithoutPop(){
-    _pred->restoreExtensionWithoutPop();
-    _pred->restoreNonExtensionWithoutPop();
-}
-
-
-void Node::updateExtensions(){
-    _pred->updateExtension();
-    _pred->updateNonExtension();
+inline bool Node::inScc(int n){
+    return _sccIndex == n;
 }
 
 
@@ -289,12 +270,8 @@ class Graph{
 //***************************** MEMBER VARIABLES *****************************//
 
     protected:
-        Node::Set _nodes;
-
-        std::stack<Node*> _stack;
-
-        /// current SCC 
-        Node::Set _scc;
+        /// nodes, by creation number
+        Node::Vector _nodes;
 
         /// all SCC
         std::vector<Node::Set> _sccVector;
@@ -302,9 +279,6 @@ class Graph{
         /// true at index 'i' iff scc 'i' is solved (stratified)
         std::vector<bool> _solved;
 
-        ///visit of a node 
-        int _date;
-
         /// indexes in _sccVector of non stratified scc
         std::vector<int> _non_stratified_sccVector;
 
@@ -335,24 +309,11 @@ class Graph{
     public:
         Node* new_Node(Predicate*);
 
+        /// number the scc in reverse topological order (an scc after the ones it depends on)
         void computeSCC();
 
-        inline int nextDate();
-
-        inline void pushStack(Node* n);
-
-        inline void popStack();
-
-        inline Node* topStack();
-
-        inline void addNode2scc(Node* n);
-
-        inline void saveAndClearSCC();
-
         inline int numberOfScc();
 
-        inline void setSccIndex(int n);
-
         inline bool firstScc(int& index);
 
         inline bool nextScc(int& index);
@@ -361,12 +322,18 @@ class Graph{
 
         void getRulesFromScc(int index, ruleSet& recRules, ruleSet& exitRules, Program&);
 
+        /// for each scc, dependents receives the sccs that depend on it and dependencies the number of sccs it depends on
+        void getSccDependencies(std::vector<intVector>& dependents, intVector& dependencies);
+
         bool existsMbtInstance(int index);
 
         void addDefiniteRulesContainingNotP(int index, ruleMultimap& rmap);
 
         void addConstraintsContainingNotP(int index, ruleSet& rset);
 
+        /// add to preds the negated predicates of the predicates of scc 'index'
+        void addNegatedPredicates(int index, std::vector<Predicate*>& preds);
+
         void initNonStratifiedSccVector();
 
         /// true if scc does not contain internal negative arc
@@ -402,15 +369,8 @@ class Graph{
 
         bool emptyDelta(int index);
 
-        /// record known extensions and non-extensions of predicates whose scc is greater or equal than 'sccIndex' (for back-track)
-        void recordExtensions(int sccIndex);
-
-        /// restore previous extensions and non-extensions of predicates whose scc is greater or equal than 'sccIndex' 
-        void restoreExtensions(int sccIndex);
-
-        void restoreExtensionsWithoutPop(int sccIndex);
-
-        void updateExtensions(int sccIndex);
+        /// number of instances in the deltas of the predicates of scc 'index'
+        int deltaSize(int index);
 
         void restoreNonSolvedScc(int first, int last);
 
@@ -428,8 +388,16 @@ inline std::ostream& operator << (std::ostream& os, Node::Set& ns){
 }
 
 
+inline std::ostream& operator << (std::ostream& os, Node::Vector& nv){
+    os << '{';
+    for (Node::Vector::iterator it = nv.begin(); it != nv.end(); it++)
+        os << ((it == nv.begin()) ? "" : ",") << *(*it);
+    return os << '}';
+}
+
+
 inline std::ostream& operator << (std::ostream& os , Graph& g){
-    for (Node::Set::iterator it = g._nodes.begin(); it != g._nodes.end(); it++)
+    for (Node::Vector::iterator it = g._nodes.begin(); it != g._nodes.end(); it++)
         os << *(*it) << " + "<< (*it)->getPosSucc() << '-' << (*it)->getNegSucc() << std::endl;
     return os;
 }
@@ -447,38 +415,6 @@ inline std::ostream& operator << (std::ostream& os, std::vector<Node::Set>& v){
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
 
-inline int Graph::nextDate(){
-    return ++_date;
-}
-
-
-inline void Graph::pushStack(Node* n){
-    _stack.push(n);
-}
-
-
-inline void Graph::popStack(){
-    _stack.pop();
-}
-
-
-inline Node* Graph::topStack(){
-    return _stack.top();
-}
-
-
-inline void Graph::addNode2scc(Node* n){
-    _scc.insert(n);
-}
-
-
-inline void Graph::saveAndClearSCC(){
-    _sccVector.push_back(_scc);
-    setSccIndex(_sccVector.size()-1);
-    _scc.clear();
-}
-
-
 inline int Graph::numberOfScc(){
     return _sccVector.size();
 }
@@ -496,12 +432,6 @@ inline bool Graph::nextScc(int& index){
 }
 
 
-inline void Graph::setSccIndex(int n){
-    for (Node::Set::iterator it = _scc.begin(); it != _scc.end(); it++)
-        (*it)->setSccIndex(n);
-}
-
-
 inline void Graph::getNodesFromScc(int index, Node::Set& ns){
     ns = _sccVector.at(index);
 }
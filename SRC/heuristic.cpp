@@ -0,0 +1,132 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+#include <set>
+
+#include "heuristic.hpp"
+#include "rule.hpp"
+
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+Heuristic* Heuristic::create(const std::string& name){
+    if (name == "static")
+        return new StaticHeuristic();
+    if (name == "constrained")
+        return new ConstrainedHeuristic();
+    if (name == "activity")
+        return new ActivityHeuristic();
+    return NULL;
+}
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+Heuristic::Heuristic() : _frozen(false){}
+
+
+ActivityHeuristic::ActivityHeuristic() : Heuristic(), _activities(), _increment(1.0){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+Heuristic::~Heuristic(){}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+bool Heuristic::isDynamic() const{
+    return false;
+}
+
+
+void Heuristic::conflict(const std::vector<Rule*>&){}
+
+
+// creation numbers of rules follow the source order
+void StaticHeuristic::order(std::vector<Rule*>& rules){
+    std::vector< std::pair<int, Rule*> > keys;
+    for (std::vector<Rule*>::iterator it = rules.begin(); it != rules.end(); ++it)
+        keys.push_back(std::make_pair((*it)->getNumber(), *it));
+    std::sort(keys.begin(), keys.end());
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        rules[i] = keys[i].second;
+}
+
+
+void ConstrainedHeuristic::order(std::vector<Rule*>& rules){
+    std::vector< std::pair< std::pair<int, int>, Rule*> > keys;
+    for (std::vector<Rule*>::iterator it = rules.begin(); it != rules.end(); ++it)
+        keys.push_back(std::make_pair(std::make_pair(-getConstraints(*it), (*it)->getNumber()), *it));
+    std::sort(keys.begin(), keys.end());
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        rules[i] = keys[i].second;
+}
+
+
+// constraints whose body+ contains the head predicate, and rules (or constraints) that contain its negation
+// (the orders are computed before the search : prohibited instances are not counted)
+int ConstrainedHeuristic::getConstraints(Rule* r){
+    std::map<Rule*, int>::iterator it = _constraints.find(r);
+    if (it == _constraints.end()) {
+        Predicate* p = r->getHead()->getPred();
+        Predicate* notP = p->getNegatedPredicate();
+        int n = p->getBodyPlusDefiniteConstraints()->size()
+              + notP->getBodyPlusDefiniteConstraints()->size()
+              + notP->getBodyPlusDefiniteRules()->size();
+        it = _constraints.insert(std::make_pair(r, n)).first;
+    }
+    return it->second;
+}
+
+
+bool ActivityHeuristic::isDynamic() const{
+    return !_frozen;
+}
+
+
+void ActivityHeuristic::order(std::vector<Rule*>& rules){
+    std::vector< std::pair< std::pair<double, int>, Rule*> > keys;
+    for (std::vector<Rule*>::iterator it = rules.begin(); it != rules.end(); ++it)
+        keys.push_back(std::make_pair(std::make_pair(-_activities[*it], (*it)->getNumber()), *it));
+    std::sort(keys.begin(), keys.end());
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        rules[i] = keys[i].second;
+}
+
+
+// each rule is bumped once, then the increment grows by 1/0.95 ;
+// activities are scaled down before they overflow
+void ActivityHeuristic::conflict(const std::vector<Rule*>& rules){
+    if (_frozen)
+        return;
+    std::set<Rule*> bumped(rules.begin(), rules.end());
+    for (std::set<Rule*>::iterator it = bumped.begin(); it != bumped.end(); ++it)
+        _activities[*it] += _increment;
+    _increment /= 0.95;
+    if (_increment > 1e100) {
+        for (std::map<Rule*, double>::iterator it = _activities.begin(); it != _activities.end(); ++it)
+            it->second *= 1e-100;
+        _increment *= 1e-100;
+    }
+}
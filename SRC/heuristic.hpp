@@ -0,0 +1,170 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _HEURISTIC_HPP_
+#define _HEURISTIC_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "definition.hpp"
+
+
+
+/**
+ * Order in which the non definite rules of an scc are tried to find a choice point
+ * (cf. Program::orderNonDefiniteRules).
+ * A static heuristic orders the rules once, before the search ; a dynamic one orders
+ * the rules of an scc each time the search enters it, from what it has learned of the conflicts.
+ */
+class Heuristic{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// true if the heuristic does not learn anymore (cf. freeze)
+        bool _frozen;
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+    public:
+        /// heuristic of the given name (static, constrained or activity), NULL if there is none
+        static Heuristic* create(const std::string& name);
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+        Heuristic();
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        virtual ~Heuristic();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// true if the order of the rules may change during the search
+        virtual bool isDynamic() const;
+
+        /// order the rules of an scc, the first one being tried first
+        virtual void order(std::vector<Rule*>& rules) = 0;
+
+        /// rules is the rule of a refuted instance, followed by the rules of the decisions
+        /// from which the contradiction follows, if they are known
+        virtual void conflict(const std::vector<Rule*>& rules);
+
+        /// the order of the rules does not change anymore : worker processes of a parallel search
+        /// replay the choices of the main process
+        inline void freeze();
+
+
+}; // class Heuristic
+
+
+
+/**
+ * Rules in source order.
+ */
+class StaticHeuristic : public Heuristic{
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+    public:
+        void order(std::vector<Rule*>& rules);
+
+
+}; // class StaticHeuristic
+
+
+
+/**
+ * Rules whose head is the most constrained first (fail first) : the head predicate appears in the
+ * greatest number of constraints, and of rules that contain its negation.
+ * Ties are broken by source order.
+ */
+class ConstrainedHeuristic : public Heuristic{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// number of constraints on the head of each rule, computed when first needed
+        std::map<Rule*, int> _constraints;
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+    public:
+        void order(std::vector<Rule*>& rules);
+
+    protected:
+        int getConstraints(Rule* r);
+
+
+}; // class ConstrainedHeuristic
+
+
+
+/**
+ * Rules with the greatest activity first (as VSIDS) : the activity of the rules of a conflict is
+ * increased, and the increment grows after each conflict, so that recent conflicts weigh more.
+ * Ties are broken by source order.
+ */
+class ActivityHeuristic : public Heuristic{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        std::map<Rule*, double> _activities;
+
+        /// increment of the activity of a rule of the next conflict
+        double _increment;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        ActivityHeuristic();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        bool isDynamic() const;
+
+        void order(std::vector<Rule*>& rules);
+
+        void conflict(const std::vector<Rule*>& rules);
+
+
+}; // class ActivityHeuristic
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline void Heuristic::freeze(){
+    _frozen = true;
+}
+
+
+
+#endif // _HEURISTIC_HPP_
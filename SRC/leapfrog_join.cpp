@@ -0,0 +1,258 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+#include <utility>
+
+#include "leapfrog_join.hpp"
+
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+// vertices that belong to a single edge are removed, and edges included in another one :
+// the hypergraph is acyclic iff nothing remains
+bool LeapfrogJoin::isCyclic(std::vector<variableSet> edges){
+    bool reduced = true;
+    while (reduced) {
+        reduced = false;
+        for (unsigned int e = 0; e < edges.size(); ++e) {
+            variableSet::iterator v = edges[e].begin();
+            while (v != edges[e].end()) {
+                bool single = true;
+                for (unsigned int f = 0; single && (f < edges.size()); ++f)
+                    single = (f == e) || (edges[f].find(*v) == edges[f].end());
+                if (single) {
+                    edges[e].erase(v++);
+                    reduced = true;
+                }
+                else
+                    ++v;
+            }
+        }
+        for (unsigned int e = 0; e < edges.size(); ++e) {
+            bool included = edges[e].empty();
+            for (unsigned int f = 0; !included && (f < edges.size()); ++f)
+                included = (f != e) && std::includes(edges[f].begin(), edges[f].end(), edges[e].begin(), edges[e].end());
+            if (included) {
+                edges.erase(edges.begin() + e);
+                reduced = true;
+                break;
+            }
+        }
+    }
+    return !edges.empty();
+}
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+LeapfrogJoin::LeapfrogJoin() : _depth(0), _resume(false){}
+
+
+// the variables of an atom are those of its arguments that are not bound before,
+// its other arguments are bound positions if they are constants or bound variables
+LeapfrogJoin::LeapfrogJoin(const Literal::Vector& atoms, const variableSet& bound) : _members(atoms.size()), _depth(0), _resume(false){
+    for (Literal::Vector::const_iterator it = atoms.begin(); it != atoms.end(); ++it) {
+        Argument* args = (*it)->getArgs();
+        for (Argument::iterator t = args->begin(); t != args->end(); ++t)
+            if ((*t)->isVariable() && (bound.find(static_cast<Variable*>(*t)) == bound.end())
+                && (std::find(_vars.begin(), _vars.end(), *t) == _vars.end()))
+                _vars.push_back(static_cast<Variable*>(*t));
+    }
+    _participants.resize(_vars.size());
+    _turn.resize(_vars.size());
+    for (unsigned int m = 0; m < atoms.size(); ++m) {
+        Member& member = _members[m];
+        member._lit = static_cast<BasicLiteral*>(atoms[m]);
+        member._shared = NULL;
+        member._marked = false;
+        member._version = 0;
+        Argument* args = atoms[m]->getArgs();
+        for (unsigned int pos = 0; pos < args->size(); ++pos) {
+            Term* t = (*args)[pos];
+            if (t->isVariable() ? (bound.find(static_cast<Variable*>(t)) != bound.end()) : t->isConst())
+                member._columns.push_back(pos);
+        }
+        member._bound = member._columns.size();
+        for (unsigned int d = 0; d < _vars.size(); ++d) {
+            Argument::iterator t = std::find(args->begin(), args->end(), _vars[d]);
+            if (t != args->end()) {     // first occurrence of the variable (the other ones are checked by the match of the atom)
+                member._columns.push_back(t - args->begin());
+                _participants[d].push_back(m);
+            }
+        }
+        member._delta = SortedIndex(member._columns);
+    }
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+bool LeapfrogJoin::first(){
+    _resume = false;
+    if (!open())
+        return false;
+    _depth = 0;
+    return run(leapfrogInit());
+}
+
+
+// require the variables are bound (to the current match)
+bool LeapfrogJoin::next(){
+    if (_resume || changed())
+        return seek();
+    _vars[_depth]->free();
+    return run(leapfrogNext());
+}
+
+
+// a marked atom only matches its delta : its index is sorted at each opening
+bool LeapfrogJoin::open(){
+    for (std::vector<Member>::iterator m = _members.begin(); m != _members.end(); ++m) {
+        BasicLiteral* lit = m->_lit;
+        Predicate* pred = lit->getPred();
+        if (lit->getLastIndex() < lit->getFirstIndex())
+            return false;
+        m->_marked = (lit->getFirstIndex() > pred->getBeginIndex());
+        if (m->_marked)
+            m->_delta.build(pred, lit->getFirstIndex(), lit->getLastIndex());
+        else {
+            m->_shared = pred->getSortedIndex(m->_columns);
+            m->_version = m->_shared->getVersion();
+        }
+        const SortedIndex& index = m->index();
+        int row = 0;
+        int end = index.size();
+        Argument* args = lit->getArgs();
+        for (int c = 0; (c < m->_bound) && (row < end); ++c) {
+            Term* t = (*args)[m->_columns[c]]->findSubstitution();
+            if (!t)     // the term does not exist : no tuple contains it
+                return false;
+            row = index.lowerBound(row, end, c, t);
+            end = index.upperBound(row, end, c, t);
+        }
+        if (row >= end)
+            return false;
+        m->_starts.assign(1, row);
+        m->_rows.assign(1, row);
+        m->_ends.assign(1, end);
+    }
+    return true;
+}
+
+
+bool LeapfrogJoin::run(bool found){
+    for (;;) {
+        if (found) {
+            _vars[_depth]->match(_members[_participants[_depth][_turn[_depth]]].key());
+            if (_depth + 1 == _vars.size())
+                return true;
+            open(_depth++);
+            restart(_depth);
+            found = leapfrogInit();
+        }
+        else if (_depth > 0) {
+            up(--_depth);
+            _vars[_depth]->free();
+            found = leapfrogNext();
+        }
+        else
+            return false;
+    }
+}
+
+
+// the members are opened again and each variable seeks its previous value :
+// the first value found that is greater is the next match, with the first values of the next variables
+bool LeapfrogJoin::seek(){
+    Term::Vector values;
+    for (std::vector<Variable*>::iterator it = _vars.begin(); it != _vars.end(); ++it) {
+        values.push_back((*it)->applySubstitution());
+        (*it)->free();
+    }
+    _resume = false;
+    if (!open())
+        return false;
+    for (_depth = 0; ; ++_depth) {
+        for (intVector::iterator it = _participants[_depth].begin(); it != _participants[_depth].end(); ++it)
+            _members[*it].seek(values[_depth]);
+        if (!leapfrogInit())
+            return run(false);
+        if (_members[_participants[_depth][_turn[_depth]]].key() != values[_depth])
+            return run(true);
+        _vars[_depth]->match(values[_depth]);
+        if (_depth + 1 == _vars.size()) {   // previous match
+            _vars[_depth]->free();
+            return run(leapfrogNext());
+        }
+        open(_depth);
+        restart(_depth + 1);
+    }
+}
+
+
+// members are sorted by their keys
+bool LeapfrogJoin::leapfrogInit(){
+    intVector& members = _participants[_depth];
+    std::vector< std::pair<Term*, int> > keys;
+    for (intVector::iterator it = members.begin(); it != members.end(); ++it) {
+        if (_members[*it].atEnd())
+            return false;
+        keys.push_back(std::make_pair(_members[*it].key(), *it));
+    }
+    std::sort(keys.begin(), keys.end());
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        members[i] = keys[i].second;
+    _turn[_depth] = 0;
+    return leapfrogSearch();
+}
+
+
+// the member of the lowest key seeks the greatest one, until all keys are equal
+bool LeapfrogJoin::leapfrogSearch(){
+    intVector& members = _participants[_depth];
+    int n = members.size();
+    int& turn = _turn[_depth];
+    Term* max = _members[members[(turn + n - 1) % n]].key();
+    for (;;) {
+        Member& m = _members[members[turn]];
+        if (m.key() == max)
+            return true;
+        m.seek(max);
+        if (m.atEnd())
+            return false;
+        max = m.key();
+        turn = (turn + 1) % n;
+    }
+}
+
+
+bool LeapfrogJoin::leapfrogNext(){
+    intVector& members = _participants[_depth];
+    int& turn = _turn[_depth];
+    Member& m = _members[members[turn]];
+    m.next();
+    if (m.atEnd())
+        return false;
+    turn = (turn + 1) % members.size();
+    return leapfrogSearch();
+}
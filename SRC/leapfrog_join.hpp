@@ -0,0 +1,311 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _LEAPFROG_JOIN_HPP_
+#define _LEAPFROG_JOIN_HPP_
+
+#include <vector>
+
+#include "basic_literal.hpp"
+#include "context.hpp"
+#include "definition.hpp"
+#include "sorted_index.hpp"
+
+
+
+/**
+ * LeapfrogJoin matches a group of positive atoms at once (cf. RulePlan::compile), by a leapfrog
+ * triejoin : the variables of the atoms are bound one after the other, in the order of their first
+ * occurrence, and the values of a variable are the intersection of the values of the atoms that
+ * contain it, found by seeking in the extensions sorted on the bound positions and then on the
+ * variables (cf. SortedIndex). On cyclic bodies such as e(X,Y),e(Y,Z),e(Z,X), no partial match
+ * is enumerated that does not extend to a match of all the atoms of the group.
+ *
+ * Only the variables that appear as arguments are bound by the join : the atoms are then ground,
+ * and are checked by their own match (cf. RulePlan::PROBE_), which also gives their status and the
+ * index of the matched tuple. So the indexes may contain more tuples than the atoms match : a
+ * marked atom uses an index of its delta, the other ones the index of the whole extension.
+ *
+ * A match is the current bindings of the variables : when the join is resumed (cf. RulePlan::last)
+ * or when an index has changed, the next match is searched from these bindings.
+ */
+class LeapfrogJoin{
+
+//******************************* NESTED TYPES *******************************//
+
+    protected:
+        /// an atom of the join, and its iterator over the sorted index : at each level (one for each
+        /// of its variables), the rows from the current one to the end of the level agree on the
+        /// previous levels, and are sorted on the column of this level
+        class Member{
+            public:
+                BasicLiteral* _lit;
+
+                /// argument positions of the index : bound positions, then variables in join order
+                intVector _columns;
+
+                /// number of bound positions
+                int _bound;
+
+                /// index of the whole extension, shared with the other rules
+                SortedIndex* _shared;
+
+                /// index of the delta when the atom is marked
+                SortedIndex _delta;
+
+                bool _marked;
+
+                /// version of the index when it was opened
+                int _version;
+
+                /// first row, current row and end of the range of each opened level
+                intVector _starts;
+
+                intVector _rows;
+
+                intVector _ends;
+
+                inline const SortedIndex& index() const;
+
+                inline bool atEnd() const;
+
+                inline Term* key() const;
+
+                /// first row of the level whose key is not lower than t
+                inline void seek(Term* t);
+
+                /// first row of the level whose key is greater than the current one
+                inline void next();
+
+                /// next level : rows of the current key
+                inline void open();
+
+                /// back to the previous level
+                inline void up();
+
+                /// back to the first row of the level
+                inline void restart();
+        };
+
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+        /// false if groups of atoms of the current context (cf. Context) are matched one atom after the other
+        /// (cf. main option -nojoin)
+        static inline bool& _enabled();
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        std::vector<Member> _members;
+
+        /// variables of the join, in binding order
+        std::vector<Variable*> _vars;
+
+        /// for each variable, members that contain it, ordered by their keys (cf. leapfrogInit)
+        std::vector<intVector> _participants;
+
+        /// for each variable, position in _participants of the member to move
+        intVector _turn;
+
+        /// variable being bound
+        unsigned int _depth;
+
+        /// true if the next match has to be searched from the bindings (cf. resume)
+        bool _resume;
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+    public:
+        static inline void setEnabled(bool b);
+
+        static inline bool isEnabled();
+
+        /// true if the hypergraph of the variables of the atoms is cyclic (GYO reduction)
+        static bool isCyclic(std::vector<variableSet> edges);
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+        LeapfrogJoin();
+
+        /// join of atoms, knowing that variables of bound are bound before
+        LeapfrogJoin(const Literal::Vector& atoms, const variableSet& bound);
+
+
+//********************************** GETTERS *********************************//
+
+        inline const std::vector<Variable*>& getVariables() const;
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// bind the variables to the first match of the atoms, false if there is none
+        bool first();
+
+        /// bind the variables to the next match, false if there is none (and then the variables are free)
+        bool next();
+
+        /// the next match is searched from the current bindings of the variables
+        inline void resume();
+
+    protected:
+        /// open the members at their bound positions, false if one of them has no tuple there
+        bool open();
+
+        /// from the current variable, that has just been bound or not, until all variables are bound (true)
+        /// or the first one has no more value (false)
+        bool run(bool found);
+
+        /// next match after the current bindings, whatever the state of the iterators
+        bool seek();
+
+        /// first value of the current variable, from the current rows of its members
+        bool leapfrogInit();
+
+        /// value of the current variable, from the current row of its member _turn
+        bool leapfrogSearch();
+
+        /// next value of the current variable
+        bool leapfrogNext();
+
+        /// members of the variable of depth go to or come back from its next level
+        inline void open(unsigned int depth);
+
+        inline void up(unsigned int depth);
+
+        /// members of the variable of depth go back to the first row of their level
+        /// (a member that does not contain the previous variable may have moved for another value of it)
+        inline void restart(unsigned int depth);
+
+        /// true if an index has changed since the members were opened
+        inline bool changed() const;
+
+
+}; // class LeapfrogJoin
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline bool& LeapfrogJoin::_enabled(){
+    return Context::current()->_joinEnabled;
+}
+
+
+inline void LeapfrogJoin::setEnabled(bool b){
+    _enabled() = b;
+}
+
+
+inline bool LeapfrogJoin::isEnabled(){
+    return _enabled();
+}
+
+
+//********************************** GETTERS *********************************//
+
+inline const std::vector<Variable*>& LeapfrogJoin::getVariables() const{
+    return _vars;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline void LeapfrogJoin::resume(){
+    _resume = true;
+}
+
+
+inline void LeapfrogJoin::open(unsigned int depth){
+    for (intVector::iterator it = _participants[depth].begin(); it != _participants[depth].end(); ++it)
+        _members[*it].open();
+}
+
+
+inline void LeapfrogJoin::up(unsigned int depth){
+    for (intVector::iterator it = _participants[depth].begin(); it != _participants[depth].end(); ++it)
+        _members[*it].up();
+}
+
+
+inline void LeapfrogJoin::restart(unsigned int depth){
+    for (intVector::iterator it = _participants[depth].begin(); it != _participants[depth].end(); ++it)
+        _members[*it].restart();
+}
+
+
+inline bool LeapfrogJoin::changed() const{
+    for (unsigned int m = 0; m < _members.size(); ++m)
+        if (!_members[m]._marked && (_members[m]._shared->getVersion() != _members[m]._version))
+            return true;
+    return false;
+}
+
+
+inline const SortedIndex& LeapfrogJoin::Member::index() const{
+    return _marked ? _delta : *_shared;
+}
+
+
+inline bool LeapfrogJoin::Member::atEnd() const{
+    return _rows.back() >= _ends.back();
+}
+
+
+inline Term* LeapfrogJoin::Member::key() const{
+    return index().getKey(_rows.back(), _bound + _rows.size() - 1);
+}
+
+
+inline void LeapfrogJoin::Member::seek(Term* t){
+    _rows.back() = index().lowerBound(_rows.back(), _ends.back(), _bound + _rows.size() - 1, t);
+}
+
+
+inline void LeapfrogJoin::Member::next(){
+    _rows.back() = index().upperBound(_rows.back(), _ends.back(), _bound + _rows.size() - 1, key());
+}
+
+
+inline void LeapfrogJoin::Member::open(){
+    int row = _rows.back();
+    int end = index().upperBound(row, _ends.back(), _bound + _rows.size() - 1, key());
+    _starts.push_back(row);
+    _rows.push_back(row);
+    _ends.push_back(end);
+}
+
+
+inline void LeapfrogJoin::Member::up(){
+    _starts.pop_back();
+    _rows.pop_back();
+    _ends.pop_back();
+}
+
+
+inline void LeapfrogJoin::Member::restart(){
+    _rows.back() = _starts.back();
+}
+
+
+
+#endif // _LEAPFROG_JOIN_HPP_
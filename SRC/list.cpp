@@ -30,22 +30,20 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-Functor* List::_functor = Functor::newFunctor("_l", 2);
-
-
-List* List::_empty_list = EmptyList::new_EmptyList();
+//************************** STATIC MEMBER FUNCTIONS *************************//
 
+void List::init(){
+    _functor() = Functor::newFunctor("_l", 2);
+    _empty_list() = EmptyList::new_EmptyList();
+}
 
-//************************** STATIC MEMBER FUNCTIONS *************************//
 
 // creation of a list with all elements of a
 List* List::new_List(Argument* a){
     if (!a)
-        return List::_empty_list;
+        return List::_empty_list();
     else {
-        List* l = List::_empty_list;
+        List* l = List::_empty_list();
         for (Argument::iterator it = a->end(); it != a->begin(); ) 
             l = List::new_List(*(--it), l);
         return l;
@@ -58,13 +56,14 @@ List* List::new_List(Term* t, Term* l){
     Argument* a = new Argument();
     a->push_back(t);
     a->push_back(l);
-    return List::new_List(List::_functor, a);
+    return List::new_List(List::_functor(), a);
 }
 
 
 // code de FuncTerm::new_FuncTerm(Functor* f,Argument* a) en remplaçant FuncTerm par List
 // a contains head and tail
 List* List::new_List(Functor* f, Argument* a){
+    MutexLock lock(factoryMutex());
     List* li;
     variableSet* vars = new variableSet;
     a->addVariables(*vars); // each term adds its own variables to vars set
@@ -74,7 +73,7 @@ List* List::new_List(Functor* f, Argument* a){
     }
     else {  // term with vars or first occurence of term
         int depth = a->getMaxDepth() + 1;   //depth of the deepest term
-        if (depth <= _maxDepth) {
+        if (depth <= _maxDepth()) {
             li = new List(f,a,vars,depth);
             if (vars->empty())
                 f->insertGroundTerm(*a, li);
@@ -105,7 +104,7 @@ List::~List(){}
 Term* List::applySubstitution(){
     Argument* args = _args->applySubstitution();
     try {
-        Term* t = List::new_List(_functor, args);
+        Term* t = List::new_List(_functor(), args);
         return t;
     }
     catch (const OutOfRange&) {
@@ -131,7 +130,7 @@ bool List::match(Term* t){
 
 Term* List::getClone(MapVariables& mv){
     Argument* args =_args->clone(mv);
-    Term* t = List::new_List(_functor, args);
+    Term* t = List::new_List(_functor(), args);
     return t;
 }
 
@@ -180,6 +179,7 @@ List* List::append(List* l2){
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 EmptyList* EmptyList::new_EmptyList(){ 
+    MutexLock lock(factoryMutex());
     Functor* f = Functor::newFunctor("_nil", 0);
     Argument a;
     EmptyList* t = static_cast<EmptyList*>( f->existGroundTerm(a) );
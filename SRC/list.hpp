@@ -22,6 +22,7 @@
 #ifndef _LIST_HPP_
 #define _LIST_HPP_
 
+#include "context.hpp"
 #include "func_term.hpp"
 
 
@@ -45,10 +46,10 @@ class List : public FuncTerm{
 
     protected:
         /// list functor '_l'
-        static Functor* _functor;
+        static inline Functor*& _functor();
 
         /// empty list
-        static List* _empty_list;
+        static inline List*& _empty_list();
 
 
 //************************** STATIC MEMBER FUNCTIONS *************************//
@@ -63,6 +64,9 @@ class List : public FuncTerm{
 
         static inline List* getEmptyList();
 
+        /// create the list functor and the empty list again, once all functors are deleted (cf. Functor::deleteAll)
+        static void init();
+
 
 //******************************* CONSTRUCTORS *******************************//
 
@@ -114,8 +118,18 @@ class List : public FuncTerm{
 
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
+inline Functor*& List::_functor(){
+    return Context::current()->_listFunctor;
+}
+
+
+inline List*& List::_empty_list(){
+    return Context::current()->_emptyList;
+}
+
+
 inline List* List::getEmptyList(){
-    return _empty_list;
+    return _empty_list();
 }
 
 
@@ -210,6 +224,8 @@ class EmptyList : public List{
 
         inline Term* applySubstitution();
 
+        inline Term* findSubstitution();
+
         inline void free();
 
         inline Term* getClone(MapVariables&);
@@ -277,6 +293,11 @@ inline Term* EmptyList::applySubstitution(){
 }
 
 
+inline Term* EmptyList::findSubstitution(){
+    return this;
+}
+
+
 inline void EmptyList::free(){}
 
 
@@ -22,6 +22,7 @@
 #ifndef _LITERAL_HPP_
 #define _LITERAL_HPP_
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -89,11 +90,18 @@ class Literal{   // abstract class - no instance
 
         inline markEnum getMark();
 
+        inline const variableSet& getFreeVars();
+
+        inline const variableSet& getPreviousVars();
+
 
 //********************************** SETTERS *********************************//
 
         virtual inline void setMark(markEnum m);
 
+        /// set free and previous vars (as computed by Body::initVars)
+        inline void setVars(const variableSet& freeVars, const variableSet& previousVars);
+
 
 //********************************* OPERATORS ********************************//
 
@@ -189,6 +197,15 @@ class Literal{   // abstract class - no instance
         /// true if atom predicate is already solved
         virtual inline bool isSolved();
 
+        /// decisions from which the current match is derived (cf. Dependencies) - default : none
+        virtual inline const decisionSet* getDependencies();
+
+        /// true if the literal can be evaluated when variables of vs are bound - default : all its variables must be bound
+        virtual inline bool isEvaluable(const variableSet& vs);
+
+        /// estimated number of matches of the literal when variables of vs are bound - default : 0 (the literal is a test)
+        virtual inline double estimateMatches(const variableSet& vs, bool useExtension);
+
         /// default : no effect
         virtual inline void setDelta();
 
@@ -198,6 +215,9 @@ class Literal{   // abstract class - no instance
         /// default : no effect (used by PositiveLiteralOfNDR)
         virtual inline void restoreDelta();
 
+        /// default : no effect (used by BasicLiteral)
+        virtual inline void setDeltaPart(int part, int parts);
+
         /// default : no effect (used by BasicLiteral)
         virtual inline void recordIndex();
 
@@ -246,6 +266,16 @@ inline markEnum Literal::getMark(){
 }
 
 
+inline const variableSet& Literal::getFreeVars(){
+    return _free_vars;
+}
+
+
+inline const variableSet& Literal::getPreviousVars(){
+    return _previous_vars;
+}
+
+
 //********************************* OPERATORS ********************************//
 
 inline std::ostream& operator << (std::ostream& os, Literal& a){
@@ -269,6 +299,12 @@ inline void Literal::setMark(markEnum m){
 }
 
 
+inline void Literal::setVars(const variableSet& freeVars, const variableSet& previousVars){
+    _free_vars = freeVars;
+    _previous_vars = previousVars;
+}
+
+
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
 // adds its own variables to vs
@@ -402,6 +438,23 @@ inline bool Literal::isSolved(){
 }
 
 
+inline const decisionSet* Literal::getDependencies(){
+    return NULL;
+}
+
+
+// default : all variables of the literal must be bound
+inline bool Literal::isEvaluable(const variableSet& vs){
+    return std::includes(vs.begin(), vs.end(), _variables->begin(), _variables->end());
+}
+
+
+// default : the literal is a test (relational or built-in literal) that does not enumerate tuples
+inline double Literal::estimateMatches(const variableSet&, bool){
+    return 0;
+}
+
+
 // default : no effect
 inline void Literal::setDelta(){}
 
@@ -414,6 +467,9 @@ inline void Literal::initDelta(){}
 inline void Literal::restoreDelta(){}
 
 
+inline void Literal::setDeltaPart(int, int){}
+
+
 // default : no effect (used by BasicLiteral)
 inline void Literal::recordIndex(){}
 
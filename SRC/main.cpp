@@ -21,24 +21,48 @@
 
 #include <iostream>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "built_in_literal.hpp"
+#include "context.hpp"
 #include "exceptions.hpp"
 #include "func_term.hpp"
 #include "num_const.hpp"
 #include "program.hpp"
+#include "snapshot.hpp"
 
 
-extern Program* readProg(const char*,int);
+extern Program* readProg(const char*,int,const std::vector<std::string>&);
 
 using namespace std;
 
 
 int main(int argc, char** argv){
+    Context context;    // predicates and terms of the program, and limits of the terms
+    Context::Scope scope(context);
     char* f = NULL;
+    std::vector<std::string> factFiles;    // files of ground facts loaded without the parser
+    const char* saveFile = NULL;    // snapshot of the evaluated definite part
+    const char* loadFile = NULL;    // snapshot restored instead of evaluating
     int n ; // maxInt
     int number = 1; // maximum number of answer-set to compute (0 for all)
     int verbosity = 1;
+    bool batch = true;  // batch propagation
+    int jobs = 1;       // threads evaluating the definite part
+    int fixpointJobs = 1;   // threads evaluating a recursive SCC
+    int searchJobs = 1;     // processes searching for answer sets
+    bool ordered = false;   // answer sets in the order of the sequential search
+    int nogoods = 0;        // maximum number of learned nogoods
+    bool backjump = false;  // non-chronological back-track
+    const char* heuristic = "static";   // order of non definite rules
+    double timeLimit = 0;   // seconds of search (0 for no limit)
+    int choiceLimit = 0;    // choice points of search (0 for no limit)
+    int memoryLimit = 0;    // megabytes (0 for no limit)
+    double progress = 0;    // seconds between two progress lines (0 for none)
+    const char* restart = "none";   // restart policy
+    int restartBase = 100;  // bad choices before the first restart
+    double d;
     bool error = false;
     char *endptr;
     for (int c = 1; c < argc && !error; c++) {
@@ -47,6 +71,16 @@ int main(int argc, char** argv){
                 verbosity = 2;
             else if (strcmp (&argv[c][1], "quiet") == 0)
                 verbosity = 0;
+            else if (strcmp (&argv[c][1], "noplan") == 0)
+                Body::setCostBasedOrder(false);
+            else if (strcmp (&argv[c][1], "nojoin") == 0)
+                LeapfrogJoin::setEnabled(false);
+            else if (strcmp (&argv[c][1], "nobatch") == 0)
+                batch = false;
+            else if (strcmp (&argv[c][1], "ordered") == 0)
+                ordered = true;
+            else if (strcmp (&argv[c][1], "backjump") == 0)
+                backjump = true;
             else if (argv[c][1] == 'N') {
                 c++;
                 if (c < argc) {
@@ -59,6 +93,145 @@ int main(int argc, char** argv){
                 else
                     error = true;
             }
+            else if (strcmp (&argv[c][1], "j") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 1) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        jobs = n;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "jfix") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 1) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        fixpointJobs = n;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "facts") == 0) {
+                c++;
+                if (c < argc)
+                    factFiles.push_back(argv[c]);
+                else
+                    error = true;
+            }
+            else if ((strcmp (&argv[c][1], "save") == 0) || (strcmp (&argv[c][1], "load") == 0)) {
+                bool save = argv[c][1] == 's';
+                c++;
+                if (c < argc)
+                    (save ? saveFile : loadFile) = argv[c];
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "jsearch") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 1) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        searchJobs = n;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "nogoods") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 0) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        nogoods = n;
+                }
+                else
+                    error = true;
+            }
+            else if ((strcmp (&argv[c][1], "time") == 0) || (strcmp (&argv[c][1], "progress") == 0)) {
+                bool limit = argv[c][1] == 't';
+                c++;
+                if (c < argc) {
+                    d = strtod(&argv[c][0], &endptr);
+                    if ((d <= 0) || (*endptr != '\0'))
+                        error = true;
+                    else if (limit)
+                        timeLimit = d;
+                    else
+                        progress = d;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "choices") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 1) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        choiceLimit = n;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "memory") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 1) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        memoryLimit = n;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "restart") == 0) {
+                c++;
+                if (c < argc) {
+                    SearchControl control;
+                    if (control.setRestartPolicy(argv[c]))
+                        restart = argv[c];
+                    else
+                        error = true;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "restartbase") == 0) {
+                c++;
+                if (c < argc) {
+                    n = strtol(&argv[c][0], &endptr, 0);
+                    if ((n < 1) || (*endptr != '\0'))
+                        error = true;
+                    else
+                        restartBase = n;
+                }
+                else
+                    error = true;
+            }
+            else if (strcmp (&argv[c][1], "heuristic") == 0) {
+                c++;
+                if (c < argc) {
+                    Heuristic* h = Heuristic::create(argv[c]);
+                    if (h)
+                        heuristic = argv[c];
+                    else
+                        error = true;
+                    delete h;
+                }
+                else
+                    error = true;
+            }
             else if (argv[c][1] == 'F') {
                 c++;
                 if (c < argc) {
@@ -77,8 +250,27 @@ int main(int argc, char** argv){
                 cout << "\t n : n is the maximum number of answer set to compute (0 for all, default = 1)" << endl;
                 cout << "\t -N n : n is the greatest integer in your world (default : 1024)" << endl;
                 cout << "\t -F n : n is the maximum depth allowed for functional terms (default : 16)" << endl;
+                cout << "\t -facts file : load the ground facts of file (one by line, as in a program or as fields separated by tabulations or commas, the predicate first) without the parser ; the option can be repeated" << endl;
+                cout << "\t -save file : save the extensions of the predicates in file once the definite part is evaluated" << endl;
+                cout << "\t -load file : restore the extensions saved in file by a run of the same rules, instead of evaluating them again (the sccs depending on facts which have changed are evaluated)" << endl;
+                cout << "\t -j n : n is the number of threads evaluating independent SCCs of the definite part (default : 1)" << endl;
+                cout << "\t -jfix n : n is the number of threads sharing the deltas of a recursive SCC (default : 1)" << endl;
+                cout << "\t -jsearch n : n is the number of processes searching for answer sets (default : 1)" << endl;
+                cout << "\t -nogoods n : n is the maximum number of nogoods learned from contradictions (default : 0, no learning)" << endl;
+                cout << "\t -heuristic h : order in which non definite rules are chosen, h is static (source order, default), constrained (most constrained head first) or activity (rules of recent conflicts first)" << endl;
+                cout << "\t -time s : interrupt the search after s seconds (default : no limit)" << endl;
+                cout << "\t -choices n : interrupt the search after n choice points (default : no limit)" << endl;
+                cout << "\t -memory n : interrupt the search when the process uses n megabytes (default : no limit)" << endl;
+                cout << "\t -progress s : print a progress line on the error output every s seconds of search" << endl;
+                cout << "\t -restart r : go back to the first choice point after a number of bad choices, until the first answer set ; r is none (default), luby or geometric" << endl;
+                cout << "\t -restartbase n : n is the number of bad choices before the first restart (default : 100)" << endl;
                 cout << "\t -verbose : verbose version" << endl;
                 cout << "\t -quiet : quiet version" << endl;
+                cout << "\t -noplan : order rule bodies with recursive literals first and then source order (no cost estimation)" << endl;
+                cout << "\t -nojoin : match the atoms of cyclic rule bodies one after the other (no leapfrog join)" << endl;
+                cout << "\t -nobatch : propagate new atoms one by one (instead of one delta for each predicate)" << endl;
+                cout << "\t -ordered : with -jsearch, print answer sets in the order of the sequential search" << endl;
+                cout << "\t -backjump : back-track to the deepest choice point responsible for a contradiction (instead of the previous one)" << endl;
                 cout << "\t --help : print this help" << endl;
                 return 0;
             }
@@ -99,13 +291,46 @@ int main(int argc, char** argv){
     }
     Program* p = NULL;
     try {
-        p = readProg(f,verbosity);
+        p = readProg(f,verbosity,factFiles);
 	cout << endl;
         if (!p) {
             cerr << "Error in input" << endl;
             return 1;
         }
+        p->setBatchPropagation(batch);
+        p->setJobs(jobs);
+        p->setFixpointJobs(fixpointJobs);
+        p->setSearchJobs(searchJobs);
+        p->setOrderedAnswers(ordered);
+        p->setNogoods(nogoods);
+        p->setBackjumping(backjump);
+        p->setHeuristic(Heuristic::create(heuristic));
+        SearchControl& control = p->getSearchControl();
+        if (timeLimit > 0)
+            control.setTimeLimit(timeLimit);
+        if (choiceLimit > 0)
+            control.setChoiceLimit(choiceLimit);
+        if (memoryLimit > 0)
+            control.setMemoryLimit(memoryLimit);
+        if (progress > 0)
+            control.setProgress(progress);
+        control.setRestartPolicy(restart);
+        control.setRestartBase(restartBase);
+        Snapshot snapshot;
+        if (loadFile) {
+            if (snapshot.load(loadFile, *p))
+                p->setSnapshot(&snapshot);
+            else
+                cerr << "Warning : snapshot of other rules, not restored." << endl;
+        }
+        if (saveFile)
+            snapshot.record(*p);
         p->evaluate();
+        p->setSnapshot(NULL);
+        if (saveFile)
+            snapshot.save(saveFile);
+        if (loadFile && (verbosity > 1))
+            cout << "Restored predicates : " << snapshot.getRestored() << endl;
         if (p->isDefinite()) {
             //cout<<"Program is definite"<<endl;
             if (p->existsSupportedNonBlockedProhibitedRule()) {
@@ -118,11 +343,24 @@ int main(int argc, char** argv){
         }
         else {
             //cout << "Non definite Program" << endl;
-            if (!p->answerSetSearch(number))
+            int found = p->answerSetSearch(number);
+            if (control.getInterruption())
+                cout << "############### Search interrupted (" << control.getInterruption() << ")" << endl;
+            else if (!found)
                 cout << "############### No answer set" << endl;
         }
-        if (verbosity > 1)
+        if (verbosity > 1) {
 	    cout << "Total choice points : " << p->getChoicePoints() << endl;
+	    cout << "Total bad choices : " << p->getBadChoices() << endl;
+            if (nogoods > 0) {
+                cout << "Learned nogoods : " << p->getLearnedNogoods() << endl;
+                cout << "Nogood propagations : " << p->getNogoodPropagations() << endl;
+            }
+            if (backjump)
+                cout << "Back-jumps : " << p->getBackjumps() << endl;
+            if (control.isRestarting())
+                cout << "Restarts : " << p->getRestarts() << endl;
+        }
         delete p;
         BuiltInLiteral::closeDynamicLibraries();
         return 0;
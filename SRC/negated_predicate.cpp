@@ -42,7 +42,7 @@ statusEnum NegatedPredicate::containInstance(const Argument& term) const{
         return (_negatedPredicate->containInstance(term) == NO_) ? TRUE_ : NO_;
 
     } else {            // Return true if @term is a negative instance
-        return (_instances.find(term) != _instances.end()) ? TRUE_ : NO_;
+        return (_instances.find(term) >= 0) ? TRUE_ : NO_;
     }
 }
 
@@ -57,10 +57,17 @@ statusEnum NegatedPredicate::containInstance(const Argument& term, int begin, in
         return (_negatedPredicate->containInstance(term) == NO_) ? TRUE_ : NO_;
 
     } else {
-        int index = begin;
-        while ((index <= end) && (*(_orderedInstances.at(index).first) != term))
-            ++index;
-
-        return (index <= end) ? TRUE_ : NO_;
+        return (Predicate::containInstance(term, begin, end) != NO_) ? TRUE_ : NO_;
     }
 }
+
+
+// an instance known by the closed world assumption has no index
+int NegatedPredicate::getInstanceIndex(const Argument& term, int begin, int end) const{
+    return isSolved() ? -1 : Predicate::getInstanceIndex(term, begin, end);
+}
+
+
+const decisionSet* NegatedPredicate::getInstanceDependencies(const Argument& term) const{
+    return isSolved() ? _solvedDependencies : Predicate::getInstanceDependencies(term);
+}
@@ -60,9 +60,14 @@ class NegatedPredicate : public Predicate{
          : Predicate("__not__" + name, arity){}
 
          
-//********************************** SETTERS *********************************//
+//********************************** GETTERS *********************************//
 
     public:
+        inline bool isNegatedPredicate() const;
+
+
+//********************************** SETTERS *********************************//
+
         /* Marks a predicate as solved or not solved.
          * - solved: true if this predicate is solved, false otherwise.
          */
@@ -93,15 +98,27 @@ class NegatedPredicate : public Predicate{
          */
         virtual statusEnum containInstance(const Argument& term, int begin, int end) const;
 
+        virtual int getInstanceIndex(const Argument& term, int begin, int end) const;
+
+        virtual const decisionSet* getInstanceDependencies(const Argument& term) const;
+
 
 }; // class NegatedPredicate
 
 
+//********************************** GETTERS *********************************//
+
+inline bool NegatedPredicate::isNegatedPredicate() const{
+    return true;
+}
+
+
 //********************************** SETTERS *********************************//
 
 // Marks a predicate as solved or not solved
 inline void NegatedPredicate::setSolved(bool solved){
     _solved = solved;
+    _solvedDependencies = Dependencies::unknown();
 }
 
 
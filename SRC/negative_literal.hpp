@@ -48,6 +48,12 @@ class NegativeLiteral : public BasicLiteral{
 
         inline bool isNegativeLiteral();
 
+        /// a negative literal must be ground
+        inline bool isEvaluable(const variableSet& vs);
+
+        /// "not p(t)" holds by the closed world assumption
+        inline const decisionSet* getDependencies();
+
         /// idem for the next matching tuple
         bool nextTrueMatch();
 
@@ -89,6 +95,18 @@ inline bool NegativeLiteral::isNegativeLiteral(){
 }
 
 
+// a negative literal must be ground
+inline bool NegativeLiteral::isEvaluable(const variableSet& vs){
+    return Literal::isEvaluable(vs);
+}
+
+
+// the absence of p(t) is a conclusion only when p is solved
+inline const decisionSet* NegativeLiteral::getDependencies(){
+    return isSolved() ? _pred->getSolvedDependencies() : Dependencies::unknown();
+}
+
+
 // no sense for negative literal 
 inline void NegativeLiteral::setDelta(){
     throw RuntimeExcept("set delta for negative literal");
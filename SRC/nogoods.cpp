@@ -0,0 +1,272 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "arguments.hpp"
+#include "dependencies.hpp"
+#include "nogoods.hpp"
+#include "predicate.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+Nogoods::Nogoods() : _nogoods(), _unwatched(), _watches(), _limit(0), _fired(NULL), _learned(0), _propagated(0){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+Nogoods::Nogood::~Nogood(){
+    for (unsigned int i = 0; i < _atoms.size(); ++i)
+        delete _atoms[i].second;
+}
+
+
+Nogoods::~Nogoods(){
+    for (nogoodVector::iterator it = _nogoods.begin(); it != _nogoods.end(); ++it)
+        delete *it;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// a contradiction found by a learned nogood is not learned again
+// the atoms are sorted by decreasing level of their decisions (the body+ atoms being the last ones),
+// so that the atoms first tried as watches are the first ones to leave the model when back-tracking
+void Nogoods::learn(const ContradictoryConclusion& c){
+    bool fired = (_fired != NULL);
+    _fired = NULL;
+    if (!_limit || fired || !c.knownDecisions() || !c.getDecisions())
+        return;
+    const decisionSet& ds = *c.getDecisions();
+    std::vector< std::pair<int, atomType> > atoms;
+    std::set<int> levels;
+    for (decisionSet::const_iterator it = ds.begin(); it != ds.end(); ++it) {
+        const Dependencies::Decision& d = Dependencies::getDecision(*it);
+        levels.insert(d._level);
+        unsigned int head = 0;  // atoms of the head, replaced by the body+
+        if (d._knownBody && (d._head >= 0)) {
+            head = d._head;
+            for (std::vector<atomType>::const_iterator a = d._body.begin(); a != d._body.end(); ++a)
+                atoms.push_back(std::make_pair(1, *a));
+        }
+        for (std::vector<atomType>::const_iterator a = d._atoms.begin() + head; a != d._atoms.end(); ++a)
+            atoms.push_back(std::make_pair(-d._level, *a));
+    }
+    if (atoms.empty())
+        return;
+    std::stable_sort(atoms.begin(), atoms.end(), lessLevel);
+    Nogood* n = new Nogood(levels.size(), _learned++);
+    std::set< std::pair<Predicate*, Term::Vector> > added;  // an atom may have several indexes (MBT, then true)
+    for (unsigned int i = 0; i < atoms.size(); ++i) {
+        Predicate* p = atoms[i].second.first;
+        Tuple t = p->getOrderedInstance(atoms[i].second.second);
+        if (added.insert(std::make_pair(p, Term::Vector(t.begin(), t.end()))).second)
+            n->_atoms.push_back(std::make_pair(p, new Argument(t)));
+    }
+    _nogoods.push_back(n);
+    _unwatched.push_back(n);
+    if (_nogoods.size() > _limit)
+        reduce();
+}
+
+
+// the state is the one after back-tracking : the nogood is usually unit there
+void Nogoods::watchLearned(atomsQueue& aq){
+    if (_unwatched.empty())
+        return;
+    nogoodVector learned;
+    learned.swap(_unwatched);
+    Nogood* violated = NULL;
+    std::vector< std::pair<Nogood*, unsigned int> > units;
+    for (nogoodVector::iterator n = learned.begin(); n != learned.end(); ++n) {
+        unsigned int size = (*n)->_atoms.size();
+        unsigned int out = 0;
+        for (unsigned int i = 0; (i < size) && (out < 2); ++i)
+            if (!inModel(*n, i))
+                (*n)->_watches[out++] = i;
+        if (out == 0)
+            (*n)->_watches[0] = 0;
+        if (out < 2)   // the other watch is on an atom in the model
+            (*n)->_watches[1] = ((size > 1) && ((*n)->_watches[0] == 0)) ? 1 : 0;
+        getWatches(*n, (*n)->_watches[0]).push_back(*n);
+        if ((*n)->_watches[1] != (*n)->_watches[0])
+            getWatches(*n, (*n)->_watches[1]).push_back(*n);
+        if ((out == 0) && !violated)
+            violated = *n;
+        else if (out == 1)
+            units.push_back(std::make_pair(*n, (*n)->_watches[0]));
+    }
+    if (violated)
+        fire(violated);
+    exclude(units, aq);
+}
+
+
+// the exclusions are made once the watches of the woken nogoods are set, since they may fail
+void Nogoods::propagate(Predicate* p, int begin, int end, atomsQueue& aq){
+    std::map<Predicate*, watchMap>::iterator w = _watches.find(p);
+    if (w == _watches.end())
+        return;
+    Term::Vector tuple;     // key of the watches (the tuples of the extension are only views on their terms)
+    for (int i = begin; i <= end; ++i) {
+        Tuple t = p->getOrderedInstance(i);
+        tuple.assign(t.begin(), t.end());
+        watchMap::iterator it = w->second.find(tuple);
+        if ((it == w->second.end()) || it->second.empty())
+            continue;
+        nogoodVector woken;
+        woken.swap(it->second);
+        Nogood* violated = NULL;
+        std::vector< std::pair<Nogood*, unsigned int> > units;
+        for (nogoodVector::iterator n = woken.begin(); n != woken.end(); ++n) {
+            const std::pair<Predicate*, Argument*>& first = (*n)->_atoms[(*n)->_watches[0]];
+            int k = ((first.first == p) && (*first.second == tuple)) ? 0 : 1;
+            if (violated || !rewatch(*n, k)) {  // kept on its atom, until it is removed from the model
+                it->second.push_back(*n);
+                unsigned int other = (*n)->_watches[1 - k];
+                if (violated)
+                    continue;
+                else if (inModel(*n, other))
+                    violated = *n;
+                else
+                    units.push_back(std::make_pair(*n, other));
+            }
+            else
+                getWatches(*n, (*n)->_watches[k]).push_back(*n);
+        }
+        if (violated)
+            fire(violated);
+        exclude(units, aq);
+    }
+}
+
+
+// nogoods are deleted by increasing activity, then decreasing LBD, then from the oldest one,
+// those whose LBD is at most 2 being the last ones ; activities of the kept nogoods are halved
+void Nogoods::reduce(){
+    typedef std::pair< std::pair<bool, unsigned int>, std::pair<int, int> > keyType;
+    std::vector< std::pair<keyType, Nogood*> > order;
+    nogoodVector unwatched;
+    unwatched.swap(_unwatched);
+    for (nogoodVector::iterator it = _nogoods.begin(); it != _nogoods.end(); ++it) {
+        const Nogood* n = *it;
+        keyType key(std::make_pair(n->_lbd <= 2, n->_activity), std::make_pair(-n->_lbd, n->_rank));
+        order.push_back(std::make_pair(key, *it));
+    }
+    std::sort(order.begin(), order.end());
+    _nogoods.clear();
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        Nogood* n = order[i].second;
+        bool watched = (std::find(unwatched.begin(), unwatched.end(), n) == unwatched.end());
+        if (i < order.size() / 2) {
+            if (watched) {
+                erase(getWatches(n, n->_watches[0]), n);
+                if (n->_watches[1] != n->_watches[0])
+                    erase(getWatches(n, n->_watches[1]), n);
+            }
+            delete n;
+        }
+        else {
+            n->_activity /= 2;
+            _nogoods.push_back(n);
+            if (!watched)
+                _unwatched.push_back(n);
+        }
+    }
+}
+
+
+bool Nogoods::inModel(const Nogood* n, unsigned int i){
+    return n->_atoms[i].first->containInstance(*n->_atoms[i].second) != NO_;
+}
+
+
+Nogoods::nogoodVector& Nogoods::getWatches(const Nogood* n, unsigned int i){
+    const Argument& tuple = *n->_atoms[i].second;
+    return _watches[n->_atoms[i].first][tuple];
+}
+
+
+// the atoms following the watched one are tried first
+bool Nogoods::rewatch(Nogood* n, int k){
+    unsigned int size = n->_atoms.size();
+    for (unsigned int j = 1; j < size; ++j) {
+        unsigned int i = (n->_watches[k] + j) % size;
+        if ((i != n->_watches[1 - k]) && !inModel(n, i)) {
+            n->_watches[k] = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void Nogoods::fire(Nogood* n){
+    ++n->_activity;
+    _fired = n;
+    throw Dependencies::contradiction(getDependencies(n, n->_atoms.size()));
+}
+
+
+// nothing is added to a solved predicate : its atoms are known to be in or out of the model
+void Nogoods::exclude(const std::vector< std::pair<Nogood*, unsigned int> >& units, atomsQueue& aq){
+    for (unsigned int u = 0; u < units.size(); ++u) {
+        Nogood* n = units[u].first;
+        unsigned int i = units[u].second;
+        Predicate* p = n->_atoms[i].first;
+        Argument& tuple = *n->_atoms[i].second;
+        if (p->isSolved() || inModel(n, i))
+            continue;
+        Dependencies::Scope scope(getDependencies(n, i));
+        if (p->isNegatedPredicate() ? p->getNegatedPredicate()->addMbtInstance(tuple, aq) : p->addNonInstance(tuple, aq)) {
+            ++n->_activity;
+            ++_propagated;
+        }
+    }
+}
+
+
+const decisionSet* Nogoods::getDependencies(const Nogood* n, unsigned int i){
+    const decisionSet* ds = NULL;
+    if (Dependencies::tracking())
+        for (unsigned int j = 0; (j < n->_atoms.size()) && (ds != Dependencies::UNKNOWN); ++j)
+            if (j != i)
+                ds = Dependencies::merge(ds, n->_atoms[j].first->getInstanceDependencies(*n->_atoms[j].second));
+    return ds;
+}
+
+
+bool Nogoods::lessLevel(const std::pair<int, atomType>& a, const std::pair<int, atomType>& b){
+    return a.first < b.first;
+}
+
+
+void Nogoods::erase(nogoodVector& v, Nogood* n){
+    for (nogoodVector::size_type i = v.size(); i > 0; --i)
+        if (v[i-1] == n) {
+            v.erase(v.begin() + (i - 1));
+            return;
+        }
+}
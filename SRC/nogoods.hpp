@@ -0,0 +1,218 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _NOGOODS_HPP_
+#define _NOGOODS_HPP_
+
+#include <map>
+#include <vector>
+
+#include "definition.hpp"
+#include "term.hpp"
+
+
+class Argument;
+
+
+
+/**
+ * Nogoods learned from the contradictory conclusions of the answer set search.
+ * When the decisions that lead to a contradiction are known (cf. Dependencies), the atoms they
+ * have added can't be all in an answer set. The head of a decision is replaced by the body+ of
+ * its rule instance, from which it is derived as soon as the body- is excluded : a nogood is then
+ * made of the body+ atoms and of the body- non-instances (not_p(t)) of its decisions.
+ * Unlike the prohibited rules, learned nogoods are kept when back-tracking.
+ * Each nogood watches two of its atoms that are not in the model, and is only woken when one of them
+ * is added (cf. Program::propagateBis) : it then watches another atom, or it is violated if the other
+ * watched atom is in the model too, or else this atom is excluded (p(t) becomes a non-instance of p,
+ * and not_p(t) makes p(t) must-be-true), which prohibits the rule instances of its decision.
+ * As for the prohibitions, the watches need not be restored when back-tracking. A nogood being a
+ * consequence of the program, a violation missed by the watches (atom entering the model by the
+ * closed world assumption...) is found again by the rules.
+ * The store is bounded : when it is full, the less active half of the nogoods is deleted, those
+ * whose atoms come from at most two levels of the search (LBD) being kept as long as possible.
+ */
+class Nogoods{
+
+//******************************* NESTED TYPES *******************************//
+
+    protected:
+        class Nogood{
+            public:
+                inline Nogood(int lbd, int rank);
+
+                ~Nogood();
+
+            private:
+                /// not copyable
+                Nogood(const Nogood&);
+
+            public:
+                /// atoms that can't be all in the model
+                std::vector< std::pair<Predicate*, Argument*> > _atoms;
+
+                /// indexes in _atoms of the two watched atoms
+                unsigned int _watches[2];
+
+                /// number of distinct levels of the decisions of the nogood
+                int _lbd;
+
+                /// number of contradictions found by the nogood (halved when the store is reduced)
+                unsigned int _activity;
+
+                /// number of nogoods learned before this one
+                int _rank;
+        };
+
+        typedef std::vector<Nogood*> nogoodVector;
+
+        /// nogoods watching each tuple of a predicate
+        typedef std::map<Term::Vector, nogoodVector> watchMap;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        nogoodVector _nogoods;
+
+        /// nogoods learned since the last propagation, whose atoms are not watched yet
+        nogoodVector _unwatched;
+
+        std::map<Predicate*, watchMap> _watches;
+
+        /// maximum number of nogoods in the store, 0 if nogoods are not learned
+        unsigned int _limit;
+
+        /// nogood violated by the last contradictory conclusion, NULL if there is none
+        Nogood* _fired;
+
+        /// number of nogoods learned
+        int _learned;
+
+        /// number of atoms excluded by the nogoods
+        int _propagated;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        Nogoods();
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        ~Nogoods();
+
+
+//********************************** GETTERS *********************************//
+
+        inline int getLearnedNumber() const;
+
+        inline int getPropagatedNumber() const;
+
+        inline bool isLearning() const;
+
+
+//********************************** SETTERS *********************************//
+
+        inline void setLimit(unsigned int n);
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// learn the nogood of contradictory conclusion c
+        void learn(const ContradictoryConclusion& c);
+
+        /// watch the nogoods learned since the last propagation, exclude the last atom of those that are unit
+        /// @throw ContradictoryConclusion if a nogood is violated
+        void watchLearned(atomsQueue& aq);
+
+        /// the tuples of index begin to end of p are added to the model : wake the nogoods that watch them,
+        /// and exclude the last atom of those whose other atoms are all in the model (pushed in aq)
+        /// @throw ContradictoryConclusion if a nogood is violated
+        void propagate(Predicate* p, int begin, int end, atomsQueue& aq);
+
+    protected:
+        /// delete the worse half of the nogoods
+        void reduce();
+
+        /// true if the i-th atom of n is in the model
+        static bool inModel(const Nogood* n, unsigned int i);
+
+        /// nogoods watching the i-th atom of n
+        nogoodVector& getWatches(const Nogood* n, unsigned int i);
+
+        /// the k-th watch of n watches another atom of n that is not in the model nor watched by its other watch
+        /// (n is not in the watches of its current atom), return false if there is none
+        static bool rewatch(Nogood* n, int k);
+
+        /// n is violated
+        /// @throw ContradictoryConclusion
+        void fire(Nogood* n);
+
+        /// exclude the atom of each unit nogood (a nogood and the index of the atom that is not in the model)
+        void exclude(const std::vector< std::pair<Nogood*, unsigned int> >& units, atomsQueue& aq);
+
+        /// decisions from which the atoms of n, except the i-th one, are in the model
+        static const decisionSet* getDependencies(const Nogood* n, unsigned int i);
+
+        /// order of the atoms of a nogood, by level of their decisions
+        static bool lessLevel(const std::pair<int, atomType>& a, const std::pair<int, atomType>& b);
+
+        static void erase(nogoodVector& v, Nogood* n);
+
+
+}; // class Nogoods
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline Nogoods::Nogood::Nogood(int lbd, int rank) : _atoms(), _lbd(lbd), _activity(0), _rank(rank){
+    _watches[0] = 0;
+    _watches[1] = 1;
+}
+
+
+//********************************** GETTERS *********************************//
+
+inline bool Nogoods::isLearning() const{
+    return _limit > 0;
+}
+
+
+inline int Nogoods::getLearnedNumber() const{
+    return _learned;
+}
+
+
+inline int Nogoods::getPropagatedNumber() const{
+    return _propagated;
+}
+
+
+//********************************** SETTERS *********************************//
+
+inline void Nogoods::setLimit(unsigned int n){
+    _limit = n;
+}
+
+
+
+#endif // _NOGOODS_HPP_
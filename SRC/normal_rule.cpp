@@ -20,6 +20,7 @@
 
 
 #include "constraint_rule.hpp"
+#include "dependencies.hpp"
 #include "normal_rule.hpp"
 #include "program.hpp"
 
@@ -46,122 +47,60 @@ NormalRule::NormalRule(BasicLiteral* a, Body* v) : Rule(a, v){}
 // evaluation of a definite non recursive rule
 void NormalRule::evaluate(){
     initMarks(NON_MARKED);
-    Literal* lit = firstLiteral();
-    bool matchFound = lit->firstTrueMatch();
-    do {
-        Literal* lit0 = lit;
-        if (matchFound) {
-            if ( (lit = nextLiteral()) )    // NULL if it was the last one
-                matchFound = lit->firstTrueMatch();
-            else {
-                lit = lit0;
-                try {
-                    Argument* tuple = getHead()->applySubstitutionOnArgs();
-                    getHead()->addInstances(*tuple, TRUE_);
-                    delete tuple;
-                }
-                catch (const OutOfRange&) { // out of range funcTerm or numConst
-                    // nothing to do
-                }
-                lit->free();
-                matchFound = lit->nextTrueMatch();
-            }
+    for (bool matchFound = _plan.first(); matchFound; matchFound = _plan.next()) {
+        try {
+            Argument* tuple = getHead()->applySubstitutionOnArgs();
+            getHead()->addInstances(*tuple, TRUE_);
+            delete tuple;
         }
-        else if ( (lit = previousLiteral()) ) { // NULL if it was the first one
-            lit->free();
-            matchFound = lit->nextTrueMatch();
+        catch (const OutOfRange&) { // out of range funcTerm or numConst
+            // nothing to do
         }
-    } while (lit);
+    }
 }
 
 
 // evaluation of a definite recursive rule
+// if _head_buffer is set, derived head tuples are buffered there (cf. ParallelFixpoint)
 void NormalRule::evaluateRec(){
     initMarks(NON_MARKED);//
-    Literal* lit = firstLiteral();
     Literal* recLit = firstRecursiveLiteral();
     recLit->setMark(MARKED);
-    bool matchFound = lit->firstTrueMatch();
-    do {
-        Literal* lit0 = lit;
-        if (matchFound) {
-            if ( (lit = nextLiteral()) )    // NULL if it was the last one
-                matchFound = lit->firstTrueMatch();
-            else {
-                lit = lit0;
-                try {
-                    Argument* tuple = getHead()->applySubstitutionOnArgs();
+    int recNumber = 0;  // number of the marked recursive literal
+    for (;;) {
+        for (bool matchFound = _plan.first(); matchFound; matchFound = _plan.next()) {
+            try {
+                Argument* tuple = getHead()->applySubstitutionOnArgs();
+                if (_head_buffer)
+                    _head_buffer->push_back(std::make_pair(recNumber, tuple));
+                else {
                     getHead()->addInstances(*tuple, TRUE_);
                     delete tuple;
                 }
-                catch (const OutOfRange&) { // out of range funcTerm or numConst
-                    // nothing to do
-                }
-                lit->free();
-                matchFound = lit->nextTrueMatch();
             }
-        }
-        else if ( (lit = previousLiteral()) ) { // NULL if it was the first one
-            lit->free();
-            matchFound = lit->nextTrueMatch();
-        }
-        else {
-            recLit->setMark(UNMARKED);
-            if ( (recLit = nextRecursiveLiteral()) ) {
-                lit = lit0;                 // first literal
-                recLit->setMark(MARKED);    // next recursive literal	
-				std::vector<Literal*>::iterator it = std::find(_orderedBody.begin(), _orderedBody.end(), recLit);
-				_orderedBody.erase(it);
-				_orderedBody.insert(_orderedBody.begin(),recLit); // insert current recursive litteral at the beginning of the body
-				_orderedBody.initVars();
-				lit = firstLiteral();
-                matchFound = lit->firstTrueMatch();
+            catch (const OutOfRange&) { // out of range funcTerm or numConst
+                // nothing to do
             }
         }
-    } while (lit);
+        recLit->setMark(UNMARKED);
+        if (!(recLit = nextRecursiveLiteral()))
+            break;
+        recLit->setMark(MARKED);    // next recursive literal
+        ++recNumber;
+        moveFirst(recLit);
+    }
 }
 
 
 // soft evaluation of a definite rule containing "_not_p(t)" after predicate "p" has been set solved
 void NormalRule::evaluate(atomsQueue& aq){
-    Literal* lit = NULL;
-    Argument* tuple = NULL;
     try {
         initMarks(NON_MARKED);
-        lit = firstLiteral();
-        statusEnum matchStatus = lit->firstSoftMatch(TRUE_);
-        do {
-            Literal* lit0 = lit;
-            if (matchStatus) {    // a match is found
-                if ( (lit = nextLiteral()) ) {  // NULL if it was the last one
-                    matchStatus = lit->firstSoftMatch(matchStatus);
-                }
-                else {
-                    lit = lit0; // last literal
-                    try {
-                        tuple = getHead()->applySubstitutionOnArgs();
-                        getHead()->addInstances(*tuple, matchStatus, aq);
-                        delete tuple;
-                    }
-                    catch (const OutOfRange&) { //out of range funcTerm or numConst
-                        // nothing to do
-                    }
-                    lit->free();
-                    matchStatus = lit->nextSoftMatch(previousStatus());
-                }
-            }
-            else if ( (lit = previousLiteral()) ) { // NULL if it was the first one
-                lit->free();
-                matchStatus = lit->nextSoftMatch(previousStatus());
-            }
-        } while (lit);
+        for (statusEnum matchStatus = _plan.firstSoft(); matchStatus; matchStatus = _plan.nextSoft())
+            deriveHead(matchStatus, aq);
     }
     catch (const ContradictoryConclusion&) {
-        delete tuple;
-        do {
-            lit->free();
-            lit = previousLiteral();
-        } while(lit);
+        _plan.release();
         throw;  //exception relancée
     }
 }
@@ -170,76 +109,80 @@ void NormalRule::evaluate(atomsQueue& aq){
 // "soft" evaluation of a definite rule
 // recursive literals are those whose body+ contains a predicate whose extension has been modified
 void NormalRule::evaluateRec(atomsQueue& aq){
-    Literal* lit = NULL;
-    Argument* tuple = NULL;
     try {
         initMarks(NON_MARKED);//
-        lit = firstLiteral();
         Literal* recLit = firstRecursiveLiteral();
         recLit->setMark(MARKED);
-        statusEnum matchStatus= lit->firstSoftMatch(TRUE_);
-        do {
-            Literal* lit0 = lit;
-            if (matchStatus) {  // a match is found (TRUE_ or MBT_)
-                if ( (lit = nextLiteral()) ) {  // NULL if it was the last one
-                    matchStatus = lit->firstSoftMatch(matchStatus);
-                }
-                else {
-                    lit = lit0;
-                    try {
-                        tuple = getHead()->applySubstitutionOnArgs();
-                        getHead()->addInstances(*tuple, matchStatus, aq);
-                        delete tuple;
-                    }
-                    catch (const OutOfRange&) { //out of range funcTerm or numConst
-                        // nothing to do
-                    }
-                    lit->free();
-                    matchStatus = lit->nextSoftMatch(previousStatus());
-                }
-            }
-            else if ( (lit = previousLiteral()) ) { // NULL if it was the first one
-                lit->free();
-                matchStatus = lit->nextSoftMatch(previousStatus());
-            }
-            else {
+        for (;;) {
+            for (statusEnum matchStatus = _plan.firstSoft(); matchStatus; matchStatus = _plan.nextSoft())
+                deriveHead(matchStatus, aq);
             recLit->setMark(UNMARKED);
-                if ( (recLit = nextRecursiveLiteral()) ) {
-                    lit = lit0;                 // first literal
-                    recLit->setMark(MARKED);    // next recursive literal
-					std::vector<Literal*>::iterator it = std::find(_orderedBody.begin(), _orderedBody.end(), recLit);
-					_orderedBody.erase(it);
-					_orderedBody.insert(_orderedBody.begin(),recLit); // insert current recursive litteral at the beginning of the body
-					_orderedBody.initVars();
-					lit = firstLiteral();
-                    matchStatus = lit->firstSoftMatch(TRUE_);
-                }
-            }
-        } while (lit);
+            if (!(recLit = nextRecursiveLiteral()))
+                break;
+            recLit->setMark(MARKED);    // next recursive literal
+            moveFirst(recLit);
+        }
     }
     catch (const ContradictoryConclusion&) {
-        delete tuple;
-        do {
-            lit->free();
-            lit = previousLiteral();
-        } while(lit);
+        _plan.release();
         throw;  //exception relancée, récupérée par program::propagate
     }
 }
 
 
+// the body is matched with status : apply substitution and add head to the model
+void NormalRule::deriveHead(statusEnum status, atomsQueue& aq){
+    Argument* tuple = NULL;
+    try {
+        tuple = getHead()->applySubstitutionOnArgs();
+        Dependencies::Scope scope(_body->getDependencies());
+        getHead()->addInstances(*tuple, status, aq);
+        delete tuple;
+    }
+    catch (const OutOfRange&) { //out of range funcTerm or numConst
+        // nothing to do
+    }
+    catch (const ContradictoryConclusion&) {
+        delete tuple;
+        throw;
+    }
+}
+
+
+// insert recursive literal recLit at the beginning of the body, and compile this new order
+void NormalRule::moveFirst(Literal* recLit){
+    std::vector<Literal*>::iterator it = std::find(_orderedBody.begin(), _orderedBody.end(), recLit);
+    _orderedBody.erase(it);
+    _orderedBody.insert(_orderedBody.begin(), recLit);
+    _orderedBody.initVars();
+    unsetBodyOrder();
+    compilePlan();
+}
+
+
 // a substitution that makes the rule "true" supported and non-blocked is found
 // apply substitution and add head to the model
 // return false if head was already in or known to be out 
 bool NormalRule::addHead(Program& p, Changes& changes){
     try {
         Argument* headTuple = getHead()->applySubstitutionOnArgs();
+        Dependencies::decide(p.getSearchLevel(), this, _bodyPlus->getDependencies());
         try {
-            bool added = getHead()->addInstances(*headTuple, TRUE_, changes.getAtomsQueue());
+            bool added;
+            {
+                Dependencies::DecisionScope scope;
+                added = getHead()->addInstances(*headTuple, TRUE_, changes.getAtomsQueue());
+            }
+            if (added)
+                Dependencies::headAdded();
+            else
+                Dependencies::cancel();
             delete headTuple;
             return added;
         }
-        catch (const ContradictoryConclusion&) {
+        catch (const ContradictoryConclusion& e) {
+            Dependencies::refute(e);
+            Dependencies::cancel();
             // create an instance of the rule with current substitution, and prohibite it
             try {
                 prohibiteCurrentInstanceOfNDRWhenSearchingForChoicePoint(p, changes);
@@ -266,7 +209,8 @@ bool NormalRule::addHead(Program& p, Changes& changes){
 // return false if contradiction : body- contains head
 bool NormalRule::addBodyMinus(Program& p, Changes& changes){
     try {
-        _bodyMinus->applySubstitutionAndAddNonInstances(p, changes);
+        Dependencies::DecisionScope scope;
+        _bodyMinus->applySubstitutionAndAddNonInstances(p, changes);  // refute the decision on contradiction
         return true;
     }
     catch (const ContradictoryConclusion&) {
@@ -69,6 +69,12 @@ class NormalRule : public Rule{
     protected:
         virtual std::ostream& put(std::ostream&);
 
+        /// the body is matched with status : apply substitution and add head to the model
+        void deriveHead(statusEnum status, atomsQueue& aq);
+
+        /// insert recLit at the beginning of the ordered body (cf. evaluateRec)
+        void moveFirst(Literal* recLit);
+
 
 }; // class NormalRule
 
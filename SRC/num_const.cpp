@@ -23,24 +23,17 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-mapNumConst NumConst::_mapNumConst;
-
-
-int NumConst::_maxInt = 1024;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 NumConst* NumConst::new_NumConst(int n){
-    if ((n >= -NumConst::_maxInt) && (n <= NumConst::_maxInt)) {
-        mapNumConst::iterator it = _mapNumConst.find(n);
-        if (it!=_mapNumConst.end())
+    MutexLock lock(factoryMutex());
+    if ((n >= -NumConst::_maxInt()) && (n <= NumConst::_maxInt())) {
+        mapNumConst::iterator it = _mapNumConst().find(n);
+        if (it!=_mapNumConst().end())
             return (*it).second;
         else {
             NumConst* nc = new NumConst(n);
-            return (*_mapNumConst.insert(std::make_pair(n,nc)).first).second;
+            return (*_mapNumConst().insert(std::make_pair(n,nc)).first).second;
         }
     }
     throw OutOfRangeNumConst(); // exception
@@ -48,9 +41,9 @@ NumConst* NumConst::new_NumConst(int n){
 
 
 void NumConst::delete_all(){
-    for (mapNumConst::iterator it = _mapNumConst.begin(); it != _mapNumConst.end(); it++)
+    for (mapNumConst::iterator it = _mapNumConst().begin(); it != _mapNumConst().end(); it++)
         delete (*it).second;
-    _mapNumConst.clear();
+    _mapNumConst().clear();
 }
 
 
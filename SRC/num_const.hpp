@@ -25,6 +25,7 @@
 #include <iostream>
 
 #include "definition.hpp"
+#include "context.hpp"
 #include "term.hpp"
 
 
@@ -37,9 +38,10 @@ class NumConst : public Term{
 //************************** STATIC MEMBER VARIABLES *************************//
 
     protected:
-        static mapNumConst _mapNumConst;
+        /// constants of the current context (cf. Context), in range [-_maxInt().._maxInt()]
+        static inline mapNumConst& _mapNumConst();
 
-        static int _maxInt;
+        static inline int& _maxInt();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -54,6 +56,8 @@ class NumConst : public Term{
 
         static inline void setMaxInt(int n);
 
+        static inline int getMaxInt();
+
         static void delete_all();
 
 
@@ -95,8 +99,23 @@ class NumConst : public Term{
 
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
+inline mapNumConst& NumConst::_mapNumConst(){
+    return Context::current()->_mapNumConst;
+}
+
+
+inline int& NumConst::_maxInt(){
+    return Context::current()->_maxInt;
+}
+
+
 inline void NumConst::setMaxInt(int n){
-    _maxInt = n;
+    _maxInt() = n;
+}
+
+
+inline int NumConst::getMaxInt(){
+    return _maxInt();
 }
 
 
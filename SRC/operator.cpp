@@ -29,16 +29,11 @@
 //****************************************************************************//
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-mapOperator Operator::_mapOperator;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 Operator* Operator::new_Operator(opEnum oper){
-    mapOperator::iterator it = _mapOperator.find(oper);
-    if (it != _mapOperator.end())   // already exists
+    mapOperator::iterator it = _mapOperator().find(oper);
+    if (it != _mapOperator().end())   // already exists
         return (*it).second;
     else {
         Operator* op;
@@ -64,16 +59,16 @@ Operator* Operator::new_Operator(opEnum oper){
             default :
                 throw RuntimeExcept("Unknown arithmetic operator");
         }
-        _mapOperator.insert(std::make_pair(oper,op));
+        _mapOperator().insert(std::make_pair(oper,op));
         return op;
     }
 }
 
 
 void Operator::delete_all(){
-    for (mapOperator::iterator it = _mapOperator.begin(); it != _mapOperator.end(); it++)
+    for (mapOperator::iterator it = _mapOperator().begin(); it != _mapOperator().end(); it++)
         delete (*it).second;
-    _mapOperator.clear();
+    _mapOperator().clear();
 }
 
 
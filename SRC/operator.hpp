@@ -25,6 +25,7 @@
 #include <iostream>
 #include <cstdlib>
 
+#include "context.hpp"
 #include "definition.hpp"
 #include "num_const.hpp"
 
@@ -41,7 +42,7 @@ class Operator{  // abstract class
 //************************** STATIC MEMBER VARIABLES *************************//
 
     private:
-        static mapOperator _mapOperator;
+        static inline mapOperator& _mapOperator();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -88,6 +89,13 @@ class Operator{  // abstract class
 }; // class Operator
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline mapOperator& Operator::_mapOperator(){
+    return Context::current()->_mapOperator;
+}
+
+
 //********************************* OPERATOR *********************************//
 
 inline std::ostream& operator << (std::ostream& os, Operator& op){
@@ -0,0 +1,167 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include "parallel_fixpoint.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+ParallelFixpoint::ParallelFixpoint(Graph& g, int index, ruleSet& rules, Node::Set& ns, int parts)
+ : _graph(g), _context(*Context::current()), _index(index), _nodes(ns), _rules(rules.begin(), rules.end()), _parts(parts),
+   _copies(parts), _buffers(parts, std::vector<Rule::HeadBuffer>(rules.size())), _failed(-1), _error(NULL){
+    for (int part = 0; part < _parts; ++part) {
+        _args.push_back(std::make_pair(this, part));
+        for (unsigned int r = 0; r < _rules.size(); ++r) {
+            Rule* copy = _rules[r]->createDefiniteCopy();
+            copy->setDeltaPart(part, _parts);
+            copy->setHeadBuffer(&_buffers[part][r]);
+            _copies[part].push_back(copy);
+        }
+    }
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+ParallelFixpoint::~ParallelFixpoint(){
+    clearBuffers();
+    for (int part = 0; part < _parts; ++part)
+        for (unsigned int r = 0; r < _copies[part].size(); ++r)
+            delete _copies[part][r];
+    delete _error;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// one iteration of the semi-naive evaluation of the rules (deltas are not updated)
+void ParallelFixpoint::iterate(){
+    if (_graph.deltaSize(_index) < _minPartSize * _parts) {  // not worth threads
+        for (std::vector<Rule*>::iterator i = _rules.begin(); i != _rules.end(); i++) {
+            (*i)->orderBody(_nodes);
+            (*i)->evaluateRec();
+        }
+        return;
+    }
+    std::vector<pthread_t> threads;
+    int part = 1;
+    for ( ; part < _parts; ++part) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &ParallelFixpoint::work, &_args[part]) != 0)
+            break;  // remaining parts are evaluated by this thread
+        threads.push_back(thread);
+    }
+    work(0);
+    for ( ; part < _parts; ++part)
+        work(part);
+    for (std::vector<pthread_t>::iterator it = threads.begin(); it != threads.end(); ++it)
+        pthread_join(*it, NULL);
+    if (_failed >= 0) {
+        clearBuffers();
+        _failed = -1;
+        RuntimeExcept e(*_error);
+        throw e;
+    }
+    merge();
+}
+
+
+// thread function : arg is a pair (fixpoint, part)
+void* ParallelFixpoint::work(void* arg){
+    std::pair<ParallelFixpoint*, int>* p = static_cast<std::pair<ParallelFixpoint*, int>*>(arg);
+    Context::Scope scope(p->first->_context);
+    p->first->work(p->second);
+    return NULL;
+}
+
+
+// evaluate the copies of the rules for part 'part' of the deltas
+void ParallelFixpoint::work(int part){
+    try {
+        for (std::vector<Rule*>::iterator i = _copies[part].begin(); i != _copies[part].end(); i++) {
+            (*i)->orderBody(_nodes);
+            (*i)->evaluateRec();
+        }
+    }
+    catch (const RuntimeExcept& e) {
+        MutexLock lock(_mutex);
+        if (_failed < 0 || part < _failed) {
+            _failed = part;
+            delete _error;
+            _error = new RuntimeExcept(e);
+        }
+    }
+    catch (...) {   // e.g. std::bad_alloc : it must not leave the thread
+        MutexLock lock(_mutex);
+        if (_failed < 0 || part < _failed) {
+            _failed = part;
+            delete _error;
+            _error = new RuntimeExcept("evaluation of a part of the deltas failed");
+        }
+    }
+}
+
+
+// add buffered head tuples to the extensions, in the order of a sequential evaluation :
+// rule by rule, then for each marked recursive literal, part by part
+void ParallelFixpoint::merge(){
+    for (unsigned int r = 0; r < _rules.size(); ++r) {
+        BasicLiteral* head = _rules[r]->getHead();
+        std::vector<unsigned int> next(_parts, 0);  // next tuple of each buffer
+        bool remaining = true;
+        for (int recNumber = 0; remaining; ++recNumber) {
+            remaining = false;
+            for (int part = 0; part < _parts; ++part) {
+                Rule::HeadBuffer& buffer = _buffers[part][r];
+                unsigned int& i = next[part];
+                for ( ; i < buffer.size() && buffer[i].first == recNumber; ++i) {
+                    Argument* tuple = buffer[i].second;
+                    buffer[i].second = NULL;
+                    try {
+                        head->addInstances(*tuple, TRUE_);
+                    }
+                    catch (const OutOfRange&) { // out of range funcTerm or numConst
+                        // nothing to do
+                    }
+                    catch (...) {
+                        delete tuple;
+                        throw;
+                    }
+                    delete tuple;
+                }
+                remaining = remaining || (i < buffer.size());
+            }
+        }
+    }
+    clearBuffers();
+}
+
+
+void ParallelFixpoint::clearBuffers(){
+    for (int part = 0; part < _parts; ++part)
+        for (unsigned int r = 0; r < _buffers[part].size(); ++r) {
+            Rule::HeadBuffer& buffer = _buffers[part][r];
+            for (Rule::HeadBuffer::iterator it = buffer.begin(); it != buffer.end(); ++it)
+                delete it->second;
+            buffer.clear();
+        }
+}
@@ -0,0 +1,123 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _PARALLEL_FIXPOINT_HPP_
+#define _PARALLEL_FIXPOINT_HPP_
+
+#include <vector>
+
+#include "context.hpp"
+#include "definition.hpp"
+#include "exceptions.hpp"
+#include "graph.hpp"
+#include "rule.hpp"
+#include "threads.hpp"
+
+
+
+/**
+ * ParallelFixpoint evaluates the recursive rules of an scc with several threads.
+ * At each iteration of the semi-naive evaluation, the delta of each predicate is split in parts :
+ * each thread evaluates its own copies of the rules, whose marked literals only match one part of the delta,
+ * and buffers the derived head tuples. At the end of the iteration (when all threads are over),
+ * buffered tuples are added to the extensions in the order of a sequential evaluation.
+ * Rules only read extensions up to the end of the deltas, so buffering does not change what is derived.
+ */
+class ParallelFixpoint{
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+    protected:
+        /// minimal number of delta instances for each thread (smaller deltas are evaluated sequentially)
+        static const int _minPartSize = 256;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        Graph& _graph;
+
+        /// context of the calling thread, to which the threads are bound
+        Context& _context;
+
+        /// index of the scc
+        int _index;
+
+        /// nodes of the scc
+        Node::Set& _nodes;
+
+        /// recursive rules of the scc
+        std::vector<Rule*> _rules;
+
+        /// number of parts of the deltas (and of threads)
+        int _parts;
+
+        /// _copies[part][r] : copy of _rules[r] that matches part 'part' of the deltas
+        std::vector< std::vector<Rule*> > _copies;
+
+        /// _buffers[part][r] : head tuples derived by _copies[part][r]
+        std::vector< std::vector<Rule::HeadBuffer> > _buffers;
+
+        /// arguments of the threads
+        std::vector< std::pair<ParallelFixpoint*, int> > _args;
+
+        /// least part whose evaluation failed, -1 if none
+        int _failed;
+
+        /// exception thrown by the evaluation of part _failed
+        RuntimeExcept* _error;
+
+        Mutex _mutex;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        ParallelFixpoint(Graph& g, int index, ruleSet& rules, Node::Set& ns, int parts);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        virtual ~ParallelFixpoint();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// one iteration of the semi-naive evaluation of the rules (deltas are not updated)
+        void iterate();
+
+    protected:
+        /// thread function : arg is a pair (fixpoint, part)
+        static void* work(void* arg);
+
+        /// evaluate the copies of the rules for part 'part' of the deltas
+        void work(int part);
+
+        /// add buffered head tuples to the extensions
+        void merge();
+
+        void clearBuffers();
+
+
+}; // class ParallelFixpoint
+
+
+
+#endif // _PARALLEL_FIXPOINT_HPP_
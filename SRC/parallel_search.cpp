@@ -0,0 +1,437 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "dependencies.hpp"
+#include "exceptions.hpp"
+#include "parallel_search.hpp"
+#include "predicate.hpp"
+#include "program.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+ParallelSearch::ParallelSearch(Program& p, int jobs, bool ordered)
+ : _program(p), _jobs(jobs), _ordered(ordered), _max(0), _printed(0), _interrupted(false), _choice_points(0), _bad_choice(0),
+   _failed(false), _requests(-1), _results(-1){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+ParallelSearch::~ParallelSearch(){
+    for (workerList::iterator it = _workers.begin(); it != _workers.end(); ++it)
+        reap(*it, true);
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// search and print at most n answer sets (0 for all) below the current choice point,
+// return the number of printed answer sets
+int ParallelSearch::run(int n){
+    _max = n;
+    void (*pipeHandler)(int) = signal(SIGPIPE, SIG_IGN);    // a worker may end before reading a request
+    try {
+        _units.insert("");
+        while (!stopped() && (!_units.empty() || !_workers.empty())) {
+            while (!stopped() && !_units.empty() && ((int) _workers.size() < _jobs)) {
+                std::string unit = *_units.begin();     // least path first, for the ordered option
+                _units.erase(_units.begin());
+                start(unit);
+            }
+            wait(requestUnits() ? 10 : (_program._control.isChecking() ? 100 : -1));
+            _program._choice_points = _choice_points;   // of the finished units
+            _program._bad_choice = _bad_choice;
+            _interrupted = _program.interrupted();
+        }
+        if (_ordered)
+            printOrderedAnswers();
+    }
+    catch (...) {
+        signal(SIGPIPE, pipeHandler);
+        throw;
+    }
+    while (!_workers.empty()) {
+        reap(_workers.front(), true);
+        _workers.pop_front();
+    }
+    signal(SIGPIPE, pipeHandler);
+    if (_failed)
+        throw RuntimeExcept(_error);
+    _program._choice_points = _choice_points;
+    _program._bad_choice = _bad_choice;
+    return _printed;
+}
+
+
+// called by the worker process when an answer set is found
+void ParallelSearch::answerSet(){
+    std::ostringstream text;
+    std::streambuf* out = std::cout.rdbuf(text.rdbuf());
+    Predicate::prettyPrintAllInstances();
+    std::cout << std::endl;
+    std::cout.rdbuf(out);
+    std::string path(_path);
+    std::replace(path.begin(), path.end(), 'x', '0');
+    std::ostringstream message;
+    message << "A " << text.str().size() << ' ' << _program._choice_points << ' ' << _program._bad_choice << ' ' << path << '\n' << text.str();
+    writeAll(_results, message.str());
+}
+
+
+// fork a worker process exploring 'unit'
+void ParallelSearch::start(const std::string& unit){
+    int requests[2];
+    int results[2];
+    if (pipe(requests) != 0)
+        throw RuntimeExcept("cannot create a pipe for a search worker");
+    if (pipe(results) != 0) {
+        close(requests[0]);
+        close(requests[1]);
+        throw RuntimeExcept("cannot create a pipe for a search worker");
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {     // worker process
+        for (workerList::iterator it = _workers.begin(); it != _workers.end(); ++it) {
+            close(it->_in);
+            close(it->_out);
+        }
+        close(requests[1]);
+        close(results[0]);
+        _requests = requests[0];
+        _results = results[1];
+        work(unit);
+    }
+    close(requests[0]);
+    close(results[1]);
+    if (pid < 0) {
+        close(requests[1]);
+        close(results[0]);
+        if (_workers.empty())
+            throw RuntimeExcept("cannot fork a search worker");
+        _units.insert(unit);    // go on with the running workers
+        _jobs = _workers.size();
+        return;
+    }
+    Worker w;
+    w._pid = pid;
+    w._in = results[0];
+    w._out = requests[1];
+    w._unit = unit;
+    w._answered = false;
+    w._done = false;
+    w._asked = false;
+    w._refused = false;
+    _workers.push_back(w);
+}
+
+
+// ask busy workers for subtrees to fill idle slots
+// return true if some slot is still idle because a worker had nothing to give
+bool ParallelSearch::requestUnits(){
+    int idle = _jobs - _units.size();
+    bool refused = false;
+    for (workerList::iterator it = _workers.begin(); it != _workers.end(); ++it)
+        if (!it->_done && !it->_asked)
+            idle--;
+    for (workerList::iterator it = _workers.begin(); (it != _workers.end()) && (idle > 0); ++it) {
+        if (it->_done || it->_asked)
+            continue;
+        if (it->_refused)
+            refused = true;
+        else if (write(it->_out, "R", 1) == 1) {
+            it->_asked = true;
+            idle--;
+        }
+    }
+    return refused && (idle > 0);
+}
+
+
+// wait for messages of the workers (at most 'timeout' ms, no limit if negative) and handle them
+void ParallelSearch::wait(int timeout){
+    std::vector<pollfd> fds;
+    std::vector<workerList::iterator> workers;
+    for (workerList::iterator it = _workers.begin(); it != _workers.end(); ++it) {
+        pollfd fd;
+        fd.fd = it->_in;
+        fd.events = POLLIN;
+        fd.revents = 0;
+        fds.push_back(fd);
+        workers.push_back(it);
+    }
+    if (fds.empty())
+        return;
+    int ready = poll(&fds[0], fds.size(), timeout);
+    if ((ready < 0) && (errno != EINTR))
+        throw RuntimeExcept("cannot wait for the search workers");
+    if (timeout >= 0)   // workers that had nothing to give may be asked again
+        for (workerList::iterator it = _workers.begin(); it != _workers.end(); ++it)
+            it->_refused = false;
+    for (unsigned int i = 0; (ready > 0) && (i < fds.size()); ++i)
+        if (fds[i].revents != 0) {
+            if (!receive(*workers[i])) {
+                reap(*workers[i], false);
+                _workers.erase(workers[i]);
+            }
+        }
+    if (_ordered)
+        printOrderedAnswers();
+}
+
+
+// handle the complete messages received from w, return false if w has ended
+// messages are lines "A size choice_points bad_choice path" followed by the answer set text,
+// "S path" (given subtree, no path if none), "D choice_points bad_choice" (unit explored) and "E error"
+bool ParallelSearch::receive(Worker& w){
+    char buffer[4096];
+    ssize_t size = read(w._in, buffer, sizeof(buffer));
+    if (size < 0)
+        return errno == EINTR;
+    if (size == 0)
+        return false;
+    w._buffer.append(buffer, size);
+    std::string::size_type eol;
+    while ((eol = w._buffer.find('\n')) != std::string::npos) {
+        std::string line = w._buffer.substr(0, eol);
+        std::istringstream fields(line.substr(1));
+        if (line[0] == 'A') {
+            std::string::size_type length = 0;
+            Answer a;
+            std::string path;
+            fields >> length >> a._choice_points >> a._bad_choice >> path;
+            if (w._buffer.size() < eol + 1 + length)
+                break;  // the answer set is not completely received
+            a._text = w._buffer.substr(eol + 1, length);
+            w._buffer.erase(0, eol + 1 + length);
+            handleAnswer(w, path, a);
+            continue;
+        }
+        w._buffer.erase(0, eol + 1);
+        if (line[0] == 'S') {
+            w._asked = false;
+            if (line.size() > 2)
+                _units.insert(line.substr(2));
+            else
+                w._refused = true;
+        }
+        else if (line[0] == 'D') {
+            int choicePoints = 0;
+            int badChoice = 0;
+            fields >> choicePoints >> badChoice;
+            _choice_points += choicePoints;
+            _bad_choice += badChoice;
+            w._done = true;
+        }
+        else if (line[0] == 'E') {
+            if (!_failed) {
+                _failed = true;
+                _error = line.substr(2);
+            }
+            w._done = true;
+        }
+    }
+    return true;
+}
+
+
+void ParallelSearch::handleAnswer(Worker& w, const std::string& path, Answer& a){
+    w._last = path;
+    w._answered = true;
+    if (stopped())
+        return;
+    if (_ordered)
+        _answers[path] = a;     // printed by printOrderedAnswers
+    else
+        print(a);
+}
+
+
+// print the waiting answer sets that precede all answer sets still to be found
+// (a worker only finds answer sets of greater paths than its unit and its last answer set)
+void ParallelSearch::printOrderedAnswers(){
+    while (!_answers.empty() && !stopped()) {
+        std::map<std::string, Answer>::iterator first = _answers.begin();
+        for (workerList::iterator it = _workers.begin(); it != _workers.end(); ++it) {
+            if (it->_done)
+                continue;
+            if (it->_answered ? (it->_last < first->first) : !(first->first < it->_unit))
+                return;
+        }
+        if (!_units.empty() && !(first->first < *_units.begin()))
+            return;
+        print(first->second);
+        _answers.erase(first);
+    }
+}
+
+
+void ParallelSearch::print(const Answer& a){
+    _program._answer_number = ++_printed;
+    _program._choice_points = a._choice_points;
+    _program._bad_choice = a._bad_choice;
+    _program.printAnswerSetHeader();
+    std::cout << a._text;
+}
+
+
+// end a worker process (killed if 'force')
+void ParallelSearch::reap(Worker& w, bool force){
+    if (force)
+        kill(w._pid, SIGKILL);
+    close(w._in);
+    close(w._out);
+    int status;
+    while ((waitpid(w._pid, &status, 0) < 0) && (errno == EINTR));
+    if (!force && !w._done && !_failed) {
+        _failed = true;
+        _error = "a search worker ended unexpectedly";
+    }
+}
+
+
+// explore unit (never returns)
+void ParallelSearch::work(const std::string& unit){
+    int status = 0;
+    _program._parallel_search = this;
+    _program._heuristic->freeze();      // the choices of the unit are replayed as they were made
+    _program._max_answer_number = 0;    // the main process stops the search
+    _program._choice_points = 0;
+    _program._bad_choice = 0;
+    try {
+        _unit = unit;
+        explore();
+        std::ostringstream message;
+        message << "D " << _program._choice_points << ' ' << _program._bad_choice << '\n';
+        writeAll(_results, message.str());
+    }
+    catch (const std::exception& e) {
+        std::string error(e.what());
+        const std::string prefix(RuntimeExcept("").what());
+        if (error.compare(0, prefix.size(), prefix) == 0)
+            error.erase(0, prefix.size());
+        std::replace(error.begin(), error.end(), '\n', ' ');
+        writeAll(_results, "E " + error + "\n");
+        status = 1;
+    }
+    _exit(status);
+}
+
+
+// depth-first search of the answer sets of _unit, from the first choice point
+// (as Program::answerSetSearch, choices of the unit path are replayed first)
+void ParallelSearch::explore(){
+    Program& p = _program;
+    std::string::size_type base = _unit.size();
+    Changes* changes = p._first_state;
+    bool stop = false;
+    bool found = true;
+    bool withRule = true;
+    _path.clear();
+    for (;;) {
+        if (withRule) {
+            while (found) {
+                serveRequests();
+                p._choice_points++;
+                changes = p.recordState(true);
+                _path.push_back('0');
+                if ((_path.size() <= base) && (_unit[_path.size()-1] == '1'))
+                    found = false;  // the left branch is not part of the unit
+                else
+                    found = p.nextChoicePoint(*changes, stop);
+            }
+        }
+        if (p._chan_bool_stack.empty() || stop)
+            return;
+        std::string::size_type level = _path.size() - 1;
+        char choice = _path[level];
+        if ((level < base) && ((choice != '0') || (_unit[level] != '1')))
+            return;     // the subtree of the unit is explored
+        p.restoreState(withRule);
+        _path.erase(level);
+        p.topState(changes);
+        if (choice == '0') {    // search for an AS without the current NDR
+            Dependencies::refute(ContradictoryConclusion());    // no back-jump : the reason of the prohibition is unknown
+            changes->retropropagate(p);
+            p._bad_choice++;
+            p.prohibiteCurrentInstanceOfNDR(*changes);
+            if (p.propagate(*changes)) {
+                changes = p.recordState(false);
+                _path.push_back('1');
+                found = p.nextChoicePoint(*changes, stop);
+            }
+            else
+                stop = false;
+        }
+        else    // right branch explored, or given away
+            withRule = false;
+    }
+}
+
+
+// answer the work requests of the main process :
+// give away the right branch of the shallowest choice point of the unit whose right branch is not explored
+void ParallelSearch::serveRequests(){
+    pollfd request;
+    request.fd = _requests;
+    request.events = POLLIN;
+    request.revents = 0;
+    char c;
+    while ((poll(&request, 1, 0) > 0) && (request.revents & POLLIN) && (read(_requests, &c, 1) == 1)) {
+        std::string::size_type level = _path.find('0', _unit.size());
+        if (level == std::string::npos)
+            writeAll(_results, "S\n");
+        else {
+            _path[level] = 'x';
+            std::string unit = _path.substr(0, level);
+            std::replace(unit.begin(), unit.end(), 'x', '0');
+            writeAll(_results, "S " + unit + "1\n");
+        }
+    }
+}
+
+
+void ParallelSearch::writeAll(int fd, const std::string& s){
+    const char* data = s.data();
+    std::string::size_type size = s.size();
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            _exit(1);   // the main process is gone
+        }
+        data += written;
+        size -= written;
+    }
+}
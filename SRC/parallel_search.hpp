@@ -0,0 +1,224 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _PARALLEL_SEARCH_HPP_
+#define _PARALLEL_SEARCH_HPP_
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+
+#include <sys/types.h>
+
+
+class Program;
+
+
+
+/**
+ * ParallelSearch shares the search for answer sets between worker processes.
+ * A unit of work is a subtree of the choice tree, given by the path from the first choice point :
+ * '0' when the choice point is applied (left branch), '1' when it is not (right branch).
+ * Each unit is explored by a forked copy of the program, at the state of the first choice point,
+ * which replays the choices of the path and then searches the subtree depth first.
+ * When a worker is idle, a busy one is asked to give away the right branch of its shallowest
+ * choice point that is not yet explored (work stealing).
+ * Answer sets are sent to the main process with their path ; with the ordered option, they are
+ * printed in the order of the sequential search (increasing paths), as soon as no unit still running
+ * can find a preceding one.
+ */
+class ParallelSearch{
+
+//******************************* NESTED TYPES *******************************//
+
+    protected:
+        /// answer set found by a worker
+        class Answer{
+            public:
+                std::string _text;
+                int _choice_points;
+                int _bad_choice;
+        };
+
+        /// worker process (main process side)
+        class Worker{
+            public:
+                pid_t _pid;
+
+                /// messages from the worker
+                int _in;
+
+                /// work requests to the worker
+                int _out;
+
+                /// received but not yet handled messages
+                std::string _buffer;
+
+                /// path of the explored unit
+                std::string _unit;
+
+                /// path of the last answer set found, if _answered
+                std::string _last;
+
+                bool _answered;
+
+                /// the unit is explored
+                bool _done;
+
+                /// a subtree has been requested and not yet sent
+                bool _asked;
+
+                /// the worker had no subtree to give at the last request
+                bool _refused;
+        };
+
+        typedef std::list<Worker> workerList;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        Program& _program;
+
+        /// maximum number of worker processes
+        int _jobs;
+
+        /// answer sets are printed in the order of the sequential search
+        bool _ordered;
+
+        /// maximum number of answer sets to print (0 for all)
+        int _max;
+
+        /// number of printed answer sets
+        int _printed;
+
+        /// a limit of the search is reached (cf. SearchControl)
+        bool _interrupted;
+
+        /// choice points and bad choices of the finished units
+        int _choice_points;
+
+        int _bad_choice;
+
+        workerList _workers;
+
+        /// units waiting for a worker
+        std::set<std::string> _units;
+
+        /// answer sets waiting to be printed (ordered option), by path
+        std::map<std::string, Answer> _answers;
+
+        /// error reported by a worker
+        std::string _error;
+
+        bool _failed;
+
+        // worker process side
+
+        /// work requests from the main process
+        int _requests;
+
+        /// messages to the main process
+        int _results;
+
+        /// path of the explored unit
+        std::string _unit;
+
+        /// choices from the first choice point to the current one : '0' (left branch), '1' (right branch)
+        /// or 'x' (left branch whose right branch has been given away)
+        std::string _path;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        ParallelSearch(Program& p, int jobs, bool ordered);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        virtual ~ParallelSearch();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// search and print at most n answer sets (0 for all) below the current choice point,
+        /// return the number of printed answer sets
+        /// @throw RuntimeExcept if a worker fails
+        int run(int n);
+
+        /// called by the worker process when an answer set is found
+        void answerSet();
+
+    protected:
+        // main process side
+
+        /// fork a worker process exploring 'unit'
+        void start(const std::string& unit);
+
+        /// ask busy workers for subtrees to fill idle slots
+        /// return true if some slot is still idle because a worker had nothing to give
+        bool requestUnits();
+
+        /// wait for messages of the workers (at most 'timeout' ms, no limit if negative) and handle them
+        void wait(int timeout);
+
+        /// handle the complete messages received from w, return false if w has ended
+        bool receive(Worker& w);
+
+        void handleAnswer(Worker& w, const std::string& path, Answer& a);
+
+        /// print the waiting answer sets that precede all answer sets still to be found
+        void printOrderedAnswers();
+
+        void print(const Answer& a);
+
+        /// end a worker process (killed if it is still running)
+        void reap(Worker& w, bool kill);
+
+        inline bool stopped() const;
+
+        // worker process side
+
+        /// explore unit (never returns)
+        void work(const std::string& unit);
+
+        /// depth-first search of the answer sets of _unit
+        void explore();
+
+        /// answer the work requests of the main process
+        void serveRequests();
+
+        static void writeAll(int fd, const std::string& s);
+
+
+}; // class ParallelSearch
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline bool ParallelSearch::stopped() const{
+    return _failed || _interrupted || ((_max > 0) && (_printed >= _max));
+}
+
+
+
+#endif // _PARALLEL_SEARCH_HPP_
@@ -29,16 +29,10 @@
 
 #include "graph.hpp"
 #include "negated_predicate.hpp"
+#include "sorted_index.hpp"
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-mapPredicate Predicate::_mapPredicate;
-
-Predicate * Predicate::_truePredicate = NULL;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 // Create a new predicate and its negated predicate
@@ -61,28 +55,29 @@ Predicate* Predicate::newPredicate(const std::string& s, int n, Graph& graph){
     std::ostringstream oss;
     oss << s << '/' << n;   // cast int2string
     std::string sn = oss.str();
-    mapPredicate::iterator it = _mapPredicate.find(sn);
-    if (it != _mapPredicate.end())
+    mapPredicate::iterator it = _mapPredicate().find(sn);
+    if (it != _mapPredicate().end())
         return it->second;
     else {
         Predicate *p = newPredicateBis(s, n, graph);
-        _mapPredicate.insert(std::make_pair(sn, p));
+        _mapPredicate().insert(std::make_pair(sn, p));
 
         // Search for the opposite predicate, and link each other if it exists
         if (sn[0] == '-')
             sn.erase(sn.begin());
         else
             sn.insert(sn.begin(), '-');
-        it = _mapPredicate.find(sn);
-        if (it != _mapPredicate.end()) {
+        it = _mapPredicate().find(sn);
+        if (it != _mapPredicate().end()) {
             Predicate *np = it->second;
             p->setOppositePredicate(np);
             np->setOppositePredicate(p);
 
             // Add the extension of "np" to the non-extension of "p" (in the same order)
-            typedef std::vector< std::pair<const Argument *, statusEnum> >::const_iterator  iterator;
-            for (iterator it2 = np->_orderedInstances.begin(); it2 != np->_orderedInstances.end(); ++it2)
-                p->addNonInstance(*const_cast<Argument *>( it2->first ));
+            for (int i = 0; i < (int) np->_orderedInstances.size(); ++i) {
+                Argument tv(np->getOrderedInstance(i));
+                p->addNonInstance(tv);
+            }
         }
 
         return p;
@@ -92,33 +87,33 @@ Predicate* Predicate::newPredicate(const std::string& s, int n, Graph& graph){
 
 // create _truePredicate if it does not exist
 Predicate* Predicate::newTruePredicate(Graph& g){
-    if (!_truePredicate) {
-        _truePredicate = newPredicateBis("", 0, g); // no name, arity 0
+    if (!_truePredicate()) {
+        _truePredicate() = newPredicateBis("", 0, g); // no name, arity 0
         // true instance
         Argument tv; 
-        _truePredicate->addTrueInstance(tv);   // the only one instance is true
-        _truePredicate->setSolved(true);       // no other instance can appear
+        _truePredicate()->addTrueInstance(tv);   // the only one instance is true
+        _truePredicate()->setSolved(true);       // no other instance can appear
     }
-    return _truePredicate;
+    return _truePredicate();
 }
 
 
 Predicate* Predicate::getTruePredicate(){
-    return _truePredicate;
+    return _truePredicate();
 }
 
 
 // initialize _show property of each predicate (if different from default = true)
 bool Predicate::initShow(bool defaultShow, const stringSet& pset){
     if (!defaultShow) { // set default to false
-        for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it)
+        for (mapPredicate::iterator it = _mapPredicate().begin(); it != _mapPredicate().end(); ++it)
             it->second->hide();
     }
     // set exceptions to default value
     bool allExist = true;
     for (stringSet::const_iterator i = pset.begin(); i != pset.end(); ++i) {
-        mapPredicate::iterator it = _mapPredicate.find(*i);
-        if (it != _mapPredicate.end())
+        mapPredicate::iterator it = _mapPredicate().find(*i);
+        if (it != _mapPredicate().end())
             it->second->setShow(!defaultShow);
         else
             allExist = false;
@@ -128,29 +123,31 @@ bool Predicate::initShow(bool defaultShow, const stringSet& pset){
 
 
 bool Predicate::existsMbtInstance(){
-    mapPredicate::iterator it = _mapPredicate.begin();
-    while ((it != _mapPredicate.end()) && (it->second->getMbtNumber() == 0))
+    mapPredicate::iterator it = _mapPredicate().begin();
+    while ((it != _mapPredicate().end()) && (it->second->getMbtNumber() == 0))
         ++it;
-    return (it != _mapPredicate.end());
+    return (it != _mapPredicate().end());
 }
 
 
 void Predicate::deleteAll(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
+    for (mapPredicate::iterator it = _mapPredicate().begin(); it != _mapPredicate().end(); ++it) {
         delete it->second->getNegatedPredicate();
         delete it->second;	
     }
-    _mapPredicate.clear();
-    if (_truePredicate) {
-        delete _truePredicate->getNegatedPredicate();
-        delete _truePredicate;
-        _truePredicate = NULL;
+    _mapPredicate().clear();
+    if (_truePredicate()) {
+        delete _truePredicate()->getNegatedPredicate();
+        delete _truePredicate();
+        _truePredicate() = NULL;
     }
+    _trail().clear();
+    _records().clear();
 }
 
 
 void Predicate::printAllInstances(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
+    for (mapPredicate::iterator it = _mapPredicate().begin(); it != _mapPredicate().end(); ++it) {
         it->second->printInstances();
         it->second->printNonInstances();
     }
@@ -158,7 +155,7 @@ void Predicate::printAllInstances(){
 
 
 void Predicate::prettyPrintAllInstances(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
+    for (mapPredicate::iterator it = _mapPredicate().begin(); it != _mapPredicate().end(); ++it) {
         if (it->second->isShown())
             it->second->prettyPrintInstances();
     }
@@ -167,7 +164,7 @@ void Predicate::prettyPrintAllInstances(){
 
 
 void Predicate::prettyPrintAllNonInstances(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
+    for (mapPredicate::iterator it = _mapPredicate().begin(); it != _mapPredicate().end(); ++it) {
         if (it->second->isShown())
             it->second->prettyPrintNonInstances();
     }
@@ -175,27 +172,45 @@ void Predicate::prettyPrintAllNonInstances(){
 }
 
 
+// record all known extensions and non-extensions (for back-track) :
+// predicates (and negated predicates) are put on the trail when they are modified (cf. trail)
 void Predicate::recordExtensions(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
-        it->second->recordExtension();
-        it->second->recordNonExtension();
-    }
+    _stamp() = ++_stamps();
+    _records().push_back(std::make_pair(_trail().size(), _stamp()));
+    Dependencies::recordState();
 }
 
 
-void Predicate::restoreExtensions(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
-        it->second->restoreExtension();
-        it->second->restoreNonExtension();
-    }
+// restore extensions and non-extensions of the state recorded n states ago, and forget the n last states :
+// the n-1 last states are forgotten first, so that the trail is restored in one step
+void Predicate::restoreExtensions(unsigned int n){
+    _records().resize(_records().size() - (n - 1));
+    restoreExtensionsWithoutPop();
+    _records().pop_back();
+    _stamp() = _records().empty() ? 0 : _records().back().second;
+    Dependencies::restoreState(n);
 }
 
 
+// restore extensions and non-extensions of the last recorded state
 void Predicate::restoreExtensionsWithoutPop(){
-    for (mapPredicate::iterator it = _mapPredicate.begin(); it != _mapPredicate.end(); ++it) {
-        it->second->restoreExtensionWithoutPop();
-        it->second->restoreNonExtensionWithoutPop();
+    unsigned int size = _records().back().first;
+    while (_trail().size() > size) {
+        _trail().back().first->restoreExtension(_trail().back().second);
+        _trail().pop_back();
     }
+    _stamp() = ++_stamps();     // restored predicates have to be put on the trail again
+    _records().back().second = _stamp();
+    Dependencies::restoreStateWithoutPop();
+}
+
+
+// the last recorded state is replaced by the current one
+// (the trail is kept : it is needed to restore the previous states)
+void Predicate::updateExtensions(){
+    _stamp() = ++_stamps();
+    _records().back() = std::make_pair(_trail().size(), _stamp());
+    Dependencies::updateState();
 }
 
 
@@ -203,7 +218,7 @@ void Predicate::restoreExtensionsWithoutPop(){
 
 Predicate::Predicate(const std::string& s, int n)
  : _name(s), _arity(n), _show(true), _solved(false), _oppositePredicate(NULL), _negatedPredicate(NULL), 
-   _instances(), _orderedInstances(), _mbtNumber(0), _deltaBegin(), _deltaEnd(), _indexStack(), _node(NULL){
+   _instances(n), _orderedInstances(), _dependencies(), _solvedDependencies(NULL), _argIndexes(n), _mbtNumber(0), _deltaBegin(), _deltaEnd(), _trailStamp(0), _node(NULL){
      
 	_headDefiniteRules = new ruleSet();
 	_headNonDefiniteRules = new ruleSet();
@@ -221,6 +236,8 @@ Predicate::~Predicate(){
     delete _bodyPlusDefiniteRules;
     delete _bodyPlusNonDefiniteRules;
     delete _bodyPlusDefiniteConstraints;
+    for (std::map<intVector, SortedIndex*>::iterator it = _sortedIndexes.begin(); it != _sortedIndexes.end(); ++it)
+        delete it->second;
 }
 
 
@@ -230,9 +247,9 @@ Predicate::~Predicate(){
  * predicate, #NO_ otherwise.
  */
 statusEnum Predicate::containInstance(const Argument& term) const{
-    std::map<Argument, statusEnum>::const_iterator it = _instances.find(term);
-    return (it != _instances.end()) ?
-             it->second :               // @term is in the extension
+    int id = _instances.find(term);
+    return (id >= 0) ?
+             _instances.getStatus(id) : // @term is in the extension
              NO_;
 }
 
@@ -243,12 +260,9 @@ statusEnum Predicate::containInstance(const Argument& term) const{
  * WARNING: @term can appear first with MBT and next with TRUE_MBT status, return the last one
  */
 statusEnum Predicate::containInstance(const Argument& term, int begin, int end) const{
-    int index = end;    // Start at the end in order to find first the last status of @term
-    while ((index >= begin) && (*(_orderedInstances.at(index).first) != term))
-        --index;
-
-    return (index >= begin) ?
-             (_orderedInstances.at(index).second) :     // Status of @term
+    int id = _instances.find(term);
+    return (id >= 0) ?
+             _instances.getStatus(id, begin, end) :     // Status of @term in [@begin,@end]
              NO_;
 }
 
@@ -262,70 +276,65 @@ bool Predicate::containNonInstance(const Argument& term) const{
 }
 
 
-void Predicate::printInstances(){
-    std::cout << *this << "[solved : " << _solved << ']' << _instances;
+int Predicate::getInstanceIndex(const Argument& term, int begin, int end) const{
+    int id = _instances.find(term);
+    return (id >= 0) ? _instances.getIndex(id, begin, end) : -1;
 }
 
 
-void Predicate::printNonInstances(){
-    _negatedPredicate->printInstances();
-}
-
-
-void Predicate::prettyPrintInstances(){
-    for (std::map<Argument, statusEnum>::iterator it = _instances.begin(); it != _instances.end(); ++it)
-        std::cout << *this << it->first << ' ';
+// the tuple has to be a known instance
+const decisionSet* Predicate::getInstanceDependencies(const Argument& term) const{
+    return Dependencies::tracking() ? getDependencies(_instances.getIndex(_instances.find(term))) : NULL;
 }
 
 
-void Predicate::prettyPrintNonInstances(){
-    _negatedPredicate->prettyPrintInstances();
+// indexes are shared by the rules (and the threads that evaluate them) : they are updated under the mutex
+SortedIndex* Predicate::getSortedIndex(const intVector& columns){
+    MutexLock lock(SortedIndex::mutex());
+    SortedIndex*& index = _sortedIndexes[columns];
+    if (!index)
+        index = new SortedIndex(columns);
+    index->update(this);
+    return index;
 }
 
 
-// record known extension (for back-track)
-void Predicate::recordExtension(){
-    _indexStack.push(getEndIndex());
+void Predicate::printInstances(){
+    std::cout << *this << "[solved : " << _solved << ']' << _instances;
 }
 
 
-// record known non_extension (for back-track)
-void Predicate::recordNonExtension(){
-    _negatedPredicate->recordExtension();
+void Predicate::printNonInstances(){
+    _negatedPredicate->printInstances();
 }
 
 
-// restore previous extension
-void Predicate::restoreExtension(){
-    restoreExtensionWithoutPop();
-    _indexStack.pop();
+void Predicate::prettyPrintInstances(){
+    for (int id = 0; id < _instances.size(); ++id)
+        std::cout << *this << _instances.getTuple(id) << ' ';
 }
 
 
-// restore previous non_extension
-void Predicate::restoreNonExtension(){
-    _negatedPredicate->restoreExtension();
+void Predicate::prettyPrintNonInstances(){
+    _negatedPredicate->prettyPrintInstances();
 }
 
 
-// restore previous extension 
-void Predicate::restoreExtensionWithoutPop(){
-    int endi = _indexStack.top();  // previous end_index for _ordered_instances
-    for (int i = getEndIndex(); i > endi; i--) {
-        std::pair<const Argument*, statusEnum> tv_s = _orderedInstances.at(i);
+// restore the extension whose end index was endIndex
+void Predicate::restoreExtension(int endIndex){
+    for (int i = getEndIndex(); i > endIndex; i--) {
+        std::pair<int, statusEnum> tv_s = _orderedInstances.at(i);
+        unindexInstance(_instances.getTuple(tv_s.first));
         switch (tv_s.second) {  // status
-            case MBT_:
-                _instances.erase(*tv_s.first);
+            case MBT_:      // tv_s.first is the last tuple of _instances
+                _instances.removeLast();
                 --_mbtNumber;
                 break;
             case TRUE_:
-                _instances.erase(*tv_s.first);
+                _instances.removeLast();
                 break;
             case TRUE_MBT_:
-                {
-                    std::map<Argument, statusEnum>::iterator it = _instances.find(*tv_s.first);
-                    it->second = MBT_;  // update status
-                }
+                _instances.setStatus(tv_s.first, MBT_, -1);  // update status
                 ++_mbtNumber;
                 break;
             default:
@@ -333,25 +342,10 @@ void Predicate::restoreExtensionWithoutPop(){
         }
         _orderedInstances.pop_back();
     }
-    _deltaBegin = endi + 1;
-    _deltaEnd = endi;
-}
-
-
-// restore previous non_extension
-void Predicate::restoreNonExtensionWithoutPop(){
-    _negatedPredicate->restoreExtensionWithoutPop();
-}
-
-
-// update extension (for back-track)
-void Predicate::updateExtension(){
-    _indexStack.pop();                 // pop old value
-    _indexStack.push(getEndIndex());   // push new one
-}
-
-
-// update non_extension (for back-track)
-void Predicate::updateNonExtension(){
-    _negatedPredicate->updateExtension();
+    if (_dependencies.size() > _orderedInstances.size())
+        _dependencies.resize(_orderedInstances.size());
+    for (std::map<intVector, SortedIndex*>::iterator it = _sortedIndexes.begin(); it != _sortedIndexes.end(); ++it)
+        it->second->truncate(endIndex + 1);
+    _deltaBegin = endIndex + 1;
+    _deltaEnd = endIndex;
 }
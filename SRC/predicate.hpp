@@ -28,6 +28,7 @@
 #ifndef _PREDICATE_HPP_
 #define _PREDICATE_HPP_
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <set>
@@ -35,12 +36,16 @@
 #include <vector>
 
 #include "arguments.hpp"
+#include "context.hpp"
 #include "definition.hpp"
+#include "dependencies.hpp"
+#include "tuple_table.hpp"
 
 
 
 class Graph;
 class Node;
+class SortedIndex;
 
 
 
@@ -52,9 +57,22 @@ class Predicate {
 //************************** STATIC MEMBER VARIABLES *************************//
 
     protected:
-        static mapPredicate _mapPredicate;
+        /// tables of the current context (cf. Context)
+        static inline mapPredicate& _mapPredicate();
 
-        static Predicate* _truePredicate;
+        static inline Predicate*& _truePredicate();
+
+        /// back-track trail : predicates modified since a recorded state, with the previous end index of their extension
+        static inline std::vector< std::pair<Predicate*, int> >& _trail();
+
+        /// recorded states : size of the trail and stamp of the state
+        static inline std::vector< std::pair<unsigned int, int> >& _records();
+
+        /// stamp of the last recorded state (0 if there is none)
+        static inline int& _stamp();
+
+        /// number of stamps given
+        static inline int& _stamps();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -85,10 +103,23 @@ class Predicate {
         Predicate* _negatedPredicate;
 
         /// extension of the predicate (a tuple is TRUE_, TRUE_MBT_, or MBT_)
-        std::map<Argument, statusEnum> _instances;
+        TupleTable _instances;
+
+        /// ordered extension : number of the tuple in _instances, and its status (TRUE_, TRUE_MBT_, or MBT_)
+        std::vector< std::pair<int, statusEnum> > _orderedInstances;
+
+        /// for each tuple of _orderedInstances, decisions from which it is derived (cf. Dependencies)
+        /// tuples added before the first decision are missing at the end : they depend on no decision
+        std::vector<const decisionSet*> _dependencies;
+
+        /// decisions from which the predicate has been set solved
+        const decisionSet* _solvedDependencies;
+
+        /// for each argument position, indexes in _orderedInstances of the tuples having a given term at this position
+        std::vector<termIndexMap> _argIndexes;
 
-        /// ordered extension (a tuple is TRUE_, TRUE_MBT_, or MBT_)
-        std::vector< std::pair<const Argument*, statusEnum> > _orderedInstances;
+        /// extension sorted on some argument positions, for each sequence of positions asked (cf. LeapfrogJoin)
+        std::map<intVector, SortedIndex*> _sortedIndexes;
 
         /// number of MBT tuples in the extension
         int _mbtNumber;
@@ -97,8 +128,8 @@ class Predicate {
 
         int _deltaEnd;
 
-        /// back-track stack for _instances end index
-        intStack _indexStack;
+        /// stamp of the recorded state for which the extension is on the trail
+        int _trailStamp;
 
         /// definite rules that define the predicate
         ruleSet* _headDefiniteRules;
@@ -149,6 +180,9 @@ class Predicate {
 
         static bool existsMbtInstance();
 
+        /// all predicates, by "name/arity"
+        static inline const mapPredicate& getPredicates();
+
         /// delete all predicates
         static void deleteAll();
 
@@ -158,14 +192,19 @@ class Predicate {
 
         static void prettyPrintAllNonInstances();
 
-        /// record all known extensions and non-extensions(for back-track)
+        /// record all known extensions and non-extensions (for back-track)
         static void recordExtensions();
 
-        /// restore all previous extensions and non-extensions
-        static void restoreExtensions();
+        /// restore extensions and non-extensions of the state recorded n states ago, and forget the n last states
+        /// (the trail is walked once, whatever n)
+        static void restoreExtensions(unsigned int n = 1);
 
+        /// restore extensions and non-extensions of the last recorded state
         static void restoreExtensionsWithoutPop();
 
+        /// the last recorded state is replaced by the current one
+        static void updateExtensions();
+
 
 //******************************* CONSTRUCTORS *******************************//
 
@@ -183,6 +222,10 @@ class Predicate {
 	
         inline bool isShown() const;
 
+        inline const std::string& getName() const;
+
+        inline int getArity() const;
+
         /**
          * @brief Indicates if a predicate is solved or not.
          * @return @c true if this predicate is solved, @c false otherwise.
@@ -237,6 +280,12 @@ class Predicate {
 
         inline Node* getNode();
 
+        /// default value
+        virtual inline bool isNegatedPredicate() const;
+
+        /// number of distinct terms at argument position pos in the extension
+        inline int getTermNumber(int pos) const;
+
 
 //********************************** SETTERS *********************************//
 
@@ -285,6 +334,8 @@ class Predicate {
 
         inline void setDelta(int index);
 
+        inline void setDelta(int begin, int end);
+
         inline void setNode(Node* n);
 
 
@@ -331,6 +382,12 @@ class Predicate {
          */
         inline bool addMbtInstance_impl(Argument&);
 
+        /// add index i of tuple tv (in _orderedInstances) to the index of each argument position
+        inline void indexInstance(const Tuple& tv, int i);
+
+        /// remove the last index of tuple tv from the index of each argument position
+        inline void unindexInstance(const Tuple& tv);
+
     public:
         inline bool addMbtInstance(Argument&);
 
@@ -340,6 +397,9 @@ class Predicate {
 
         inline bool addNonInstance(Argument&, atomsQueue&);
 
+        /// make room for n more tuples in the extension (cf. RangeLiteral::addInstances)
+        inline void reserveInstances(size_t n);
+
         /**
          * @brief Returns the status of a term vector if it's a known instance
          *        of a predicate.
@@ -366,6 +426,9 @@ class Predicate {
          * during the search. So if a term vector appears several times with
          * different status, the more recent is returned.
          * 
+         * The indexes of @a term in the list are kept with the tuple, so this
+         * needs a single lookup in the extension.
+         * 
          * @sa containInstance(const Argument&),
          *     containNonInstance(const Argument&)
          */
@@ -383,6 +446,29 @@ class Predicate {
          */
         bool containNonInstance(const Argument& term) const;
 
+        /// index in the ordered extension of term if it lies between begin and end, -1 otherwise
+        /// (or if term is known to be an instance by the closed world assumption)
+        virtual int getInstanceIndex(const Argument& term, int begin, int end) const;
+
+        /// decisions from which the instance term is derived
+        virtual const decisionSet* getInstanceDependencies(const Argument& term) const;
+
+        /// tuple of index i in the ordered extension (valid until the next addition to the extension)
+        inline Tuple getOrderedInstance(int i) const;
+
+        /// status of the tuple of index i in the ordered extension
+        inline statusEnum getOrderedStatus(int i) const;
+
+        /// number of distinct tuples of the extension, and tuple of number id (as printed in an answer set)
+        inline int getInstanceNumber() const;
+        inline Tuple getInstance(int id) const;
+
+        /// decisions from which the tuple of index i in the ordered extension is derived
+        inline const decisionSet* getDependencies(int i) const;
+
+        /// decisions from which an instance known by the closed world assumption is derived
+        inline const decisionSet* getSolvedDependencies() const;
+
         void printInstances();
 
         void printNonInstances();
@@ -391,13 +477,31 @@ class Predicate {
 
         void prettyPrintNonInstances();
 
-        inline const Argument* firstTrueInstance(int& i, int begin_i, int end_i);
+        /// the null tuple if there is none
+        inline Tuple firstTrueInstance(int& i, int begin_i, int end_i);
+
+        inline Tuple nextTrueInstance(int& i, int end_i);
+
+        /// the null tuple with status NO_ if there is none
+        inline std::pair<Tuple, statusEnum> firstSoftInstance(int& i, int begin_i, int end_i);
+
+        inline std::pair<Tuple, statusEnum> nextSoftInstance(int& i, int end_i);
+
+        /// indexes (in increasing order) of the tuples whose argument at position pos is t
+        inline const intVector& getInstanceIndexes(int pos, Term* t) const;
+
+        /// the extension sorted on the argument positions of columns, up to date
+        SortedIndex* getSortedIndex(const intVector& columns);
 
-        inline const Argument* nextTrueInstance(int& i, int end_i);
+        /// idem firstTrueInstance, but only tuples whose index is in slots are considered
+        inline Tuple firstTrueInstance(int& i, int begin_i, int end_i, const intVector& slots);
 
-        inline std::pair<const Argument*, statusEnum> firstSoftInstance(int& i, int begin_i, int end_i);
+        inline Tuple nextTrueInstance(int& i, int end_i, const intVector& slots);
 
-        inline std::pair<const Argument*, statusEnum> nextSoftInstance(int& i, int end_i);
+        /// idem firstSoftInstance, but only tuples whose index is in slots are considered
+        inline std::pair<Tuple, statusEnum> firstSoftInstance(int& i, int begin_i, int end_i, const intVector& slots);
+
+        inline std::pair<Tuple, statusEnum> nextSoftInstance(int& i, int end_i, const intVector& slots);
 
         inline void addHeadDefiniteRule(Rule*);
 
@@ -421,27 +525,55 @@ class Predicate {
 
         inline int getEndIndex();
 
-        /// record known extension (for back-track)
-        void recordExtension();
+    protected:
+        /// put the extension on the trail, if it is its first modification since the last recorded state
+        inline void trail();
+
+        /// record the dependencies of the last tuple of the ordered extension
+        inline void addDependencies();
 
-        void recordNonExtension();
+        /// restore the extension whose end index was endIndex
+        void restoreExtension(int endIndex);
 
-        /// restore previous extension 
-        void restoreExtension();
 
-        void restoreNonExtension();
+}; // class Predicate
 
-        /// restore previous extension 
-        void restoreExtensionWithoutPop();
 
-        void restoreNonExtensionWithoutPop();
+//************************** STATIC MEMBER FUNCTIONS *************************//
 
-        void updateExtension();
+inline mapPredicate& Predicate::_mapPredicate(){
+    return Context::current()->_mapPredicate;
+}
 
-        void updateNonExtension();
 
+inline Predicate*& Predicate::_truePredicate(){
+    return Context::current()->_truePredicate;
+}
 
-}; // class Predicate
+
+inline std::vector< std::pair<Predicate*, int> >& Predicate::_trail(){
+    return Context::current()->_trail;
+}
+
+
+inline std::vector< std::pair<unsigned int, int> >& Predicate::_records(){
+    return Context::current()->_records;
+}
+
+
+inline int& Predicate::_stamp(){
+    return Context::current()->_stamp;
+}
+
+
+inline int& Predicate::_stamps(){
+    return Context::current()->_stamps;
+}
+
+
+inline const mapPredicate& Predicate::getPredicates(){
+    return _mapPredicate();
+}
 
 
 //********************************** GETTERS *********************************//
@@ -451,6 +583,16 @@ inline bool Predicate::isShown() const{
 }
 
 
+inline const std::string& Predicate::getName() const{
+    return _name;
+}
+
+
+inline int Predicate::getArity() const{
+    return _arity;
+}
+
+
 // Indicates if a predicate is solved or not.
 inline bool Predicate::isSolved() const{
     return _solved;
@@ -519,6 +661,48 @@ inline Node* Predicate::getNode(){
 }
 
 
+inline Tuple Predicate::getOrderedInstance(int i) const{
+    return _instances.getTuple(_orderedInstances[i].first);
+}
+
+
+inline statusEnum Predicate::getOrderedStatus(int i) const{
+    return _orderedInstances[i].second;
+}
+
+
+inline int Predicate::getInstanceNumber() const{
+    return _instances.size();
+}
+
+
+inline Tuple Predicate::getInstance(int id) const{
+    return _instances.getTuple(id);
+}
+
+
+inline const decisionSet* Predicate::getDependencies(int i) const{
+    return (i < (int)_dependencies.size()) ? _dependencies[i] : NULL;
+}
+
+
+inline const decisionSet* Predicate::getSolvedDependencies() const{
+    return _solvedDependencies;
+}
+
+
+// default value
+inline bool Predicate::isNegatedPredicate() const{
+    return false;
+}
+
+
+// number of distinct terms at argument position pos in the extension
+inline int Predicate::getTermNumber(int pos) const{
+    return _argIndexes[pos].size();
+}
+
+
 //********************************** SETTERS *********************************//
 
 inline void Predicate::setShow(bool b){
@@ -549,6 +733,7 @@ inline void Predicate::hide(){
  */
 inline void Predicate::setSolved(bool solved){
     _solved = solved;
+    _solvedDependencies = Dependencies::unknown();
     _negatedPredicate->setSolved(solved);
 }
 
@@ -575,6 +760,12 @@ inline void Predicate::setDelta(int index){
 }
 
 
+inline void Predicate::setDelta(int begin, int end){
+    _deltaBegin = begin;
+    _deltaEnd = end;
+}
+
+
 inline void Predicate::setNode(Node* n){
     _node = n;
 }
@@ -587,33 +778,31 @@ inline std::ostream& operator << (std::ostream& os, const Predicate& p){
 }
 
 
-inline std::ostream& operator << (std::ostream& os, const std::map<Argument, statusEnum>& m){
-    os << '{';
-    for (std::map<Argument, statusEnum>::const_iterator it = m.begin(); it != m.end(); ++it)
-        os << ((it == m.begin()) ? "" : ",") << it->first << it->second;
-    return os << '}' << std::endl;
-}
-
-
 //************************** OTHERS MEMBER FUNCTIONS *************************//
 
 // Adds (or updates) tv with TRUE_ status to extension of the predicate
 inline bool Predicate::addTrueInstance_impl(Argument& tv){
-    std::map<Argument, statusEnum>::iterator it = _instances.find(tv);
-    if (it != _instances.end()) {       // tv was already in the extension
-        if (it->second == MBT_) {       // with status MBT
-            it->second = TRUE_MBT_;
+    int id = _instances.find(tv);
+    if (id >= 0) {                      // tv was already in the extension
+        if (_instances.getStatus(id) == MBT_) { // with status MBT
+            trail();
+            _instances.setStatus(id, TRUE_MBT_, _orderedInstances.size());
             --_mbtNumber;
-            _orderedInstances.push_back(std::make_pair(&it->first, TRUE_MBT_));
+            _orderedInstances.push_back(std::make_pair(id, TRUE_MBT_));
+            indexInstance(_instances.getTuple(id), _orderedInstances.size() - 1);
+            addDependencies();
             return true;
         } else
             return false;
     } else {
         if (containNonInstance(tv)) {   // tv is known to be out of the extension
-            throw ContradictoryConclusion();
+            throw Dependencies::contradiction(Dependencies::merge(Dependencies::current(), _negatedPredicate->getInstanceDependencies(tv)));
         } else {
-            std::pair<std::map<Argument, statusEnum>::iterator, bool> i_b = _instances.insert(std::make_pair(tv, TRUE_));
-            _orderedInstances.push_back(std::make_pair(&(i_b.first->first), TRUE_));
+            trail();
+            id = _instances.insert(tv, TRUE_, _orderedInstances.size());
+            _orderedInstances.push_back(std::make_pair(id, TRUE_));
+            indexInstance(_instances.getTuple(id), _orderedInstances.size() - 1);
+            addDependencies();
             return true;
         }
     }
@@ -651,15 +840,17 @@ inline bool Predicate::addTrueInstance(Argument& tv, atomsQueue& aq){
 
 // Adds tv with MBT_ status to the extension of the predicate
 inline bool Predicate::addMbtInstance_impl(Argument& tv){
-    std::map<Argument, statusEnum>::iterator it = _instances.find(tv);
-    if (it != _instances.end()) {       // tv was already in the extension
+    if (_instances.find(tv) >= 0) {     // tv was already in the extension
         return false;
     } else {
         if (containNonInstance(tv)) {   // tv is known to be out of the extension
-            throw ContradictoryConclusion();
+            throw Dependencies::contradiction(Dependencies::merge(Dependencies::current(), _negatedPredicate->getInstanceDependencies(tv)));
         } else {
-            std::pair<std::map<Argument, statusEnum>::iterator, bool> i_b = _instances.insert(std::make_pair(tv, MBT_));
-            _orderedInstances.push_back(std::make_pair(&(i_b.first->first), MBT_));
+            trail();
+            int id = _instances.insert(tv, MBT_, _orderedInstances.size());
+            _orderedInstances.push_back(std::make_pair(id, MBT_));
+            indexInstance(_instances.getTuple(id), _orderedInstances.size() - 1);
+            addDependencies();
             ++_mbtNumber;
             return true;
         }
@@ -696,6 +887,35 @@ inline bool Predicate::addMbtInstance(Argument& tv, atomsQueue& aq){
 }
 
 
+// the ordered extension grows at least geometrically (cf. TupleTable::reserve)
+inline void Predicate::reserveInstances(size_t n){
+    _instances.reserve(n);
+    size_t needed = _orderedInstances.size() + n;
+    if (needed > _orderedInstances.capacity())
+        _orderedInstances.reserve(std::max(needed, 2 * _orderedInstances.capacity()));
+}
+
+
+// add index i of tuple tv (in _orderedInstances) to the index of each argument position
+// indexes are added in increasing order
+inline void Predicate::indexInstance(const Tuple& tv, int i){
+    for (int pos = 0; pos < _arity; ++pos)
+        _argIndexes[pos][tv[pos]].push_back(i);
+}
+
+
+// remove the last index of tuple tv from the index of each argument position
+// require tv is the last tuple of _orderedInstances
+inline void Predicate::unindexInstance(const Tuple& tv){
+    for (int pos = 0; pos < _arity; ++pos) {
+        termIndexMap::iterator it = _argIndexes[pos].find(tv[pos]);
+        it->second.pop_back();
+        if (it->second.empty())
+            _argIndexes[pos].erase(it);
+    }
+}
+
+
 inline bool Predicate::addNonInstance(Argument& tv){
     return _negatedPredicate->addTrueInstance(tv);
 }
@@ -709,47 +929,89 @@ inline bool Predicate::addNonInstance(Argument& tv, atomsQueue& naq){
 }
 
 
-inline const Argument * Predicate::firstTrueInstance(int& i, int begin_i, int end_i){
+inline Tuple Predicate::firstTrueInstance(int& i, int begin_i, int end_i){
     i = begin_i;
     while ((i <= end_i) && (_orderedInstances.at(i).second == MBT_))
         ++i;
     if (i <= end_i)
-        return _orderedInstances.at(i).first;
+        return _instances.getTuple(_orderedInstances.at(i).first);
     else 
-        return NULL;
+        return Tuple();
 }
 
 
-inline const Argument * Predicate::nextTrueInstance(int& i, int end_i){
+inline Tuple Predicate::nextTrueInstance(int& i, int end_i){
     ++i;
     while ((i <= end_i) && (_orderedInstances.at(i).second == MBT_))
         ++i;
     if (i <= end_i) 
-        return _orderedInstances.at(i).first;
+        return _instances.getTuple(_orderedInstances.at(i).first);
     else 
-        return NULL;
+        return Tuple();
 }
 
 
-inline std::pair<const Argument *, statusEnum> Predicate::firstSoftInstance(int& i, int begin_i, int end_i){
+inline std::pair<Tuple, statusEnum> Predicate::firstSoftInstance(int& i, int begin_i, int end_i){
     i = begin_i;
     if (i <= end_i) 
-        return _orderedInstances.at(i);
-    else {
-        const Argument *p = NULL;
-        return (std::make_pair(p, NO_));
-    }
+        return std::make_pair(_instances.getTuple(_orderedInstances.at(i).first), _orderedInstances.at(i).second);
+    else
+        return std::make_pair(Tuple(), NO_);
 }
 
 
-inline std::pair<const Argument *, statusEnum> Predicate::nextSoftInstance(int& i, int end_i){
+inline std::pair<Tuple, statusEnum> Predicate::nextSoftInstance(int& i, int end_i){
     ++i;
     if (i <= end_i) 
-        return _orderedInstances.at(i);
-    else {
-        const Argument *p = NULL;
-        return std::make_pair(p, NO_);
+        return std::make_pair(_instances.getTuple(_orderedInstances.at(i).first), _orderedInstances.at(i).second);
+    else
+        return std::make_pair(Tuple(), NO_);
+}
+
+
+// indexes (in increasing order) of the tuples whose argument at position pos is t
+inline const intVector& Predicate::getInstanceIndexes(int pos, Term* t) const{
+    static const intVector noIndexes;
+    termIndexMap::const_iterator it = _argIndexes[pos].find(t);
+    return (it != _argIndexes[pos].end()) ? it->second : noIndexes;
+}
+
+
+// only tuples whose index is in slots are considered (slots is in increasing order)
+inline Tuple Predicate::firstTrueInstance(int& i, int begin_i, int end_i, const intVector& slots){
+    intVector::const_iterator it = std::lower_bound(slots.begin(), slots.end(), begin_i);
+    while ((it != slots.end()) && (*it <= end_i) && (_orderedInstances[*it].second == MBT_))
+        ++it;
+    if ((it != slots.end()) && (*it <= end_i)) {
+        i = *it;
+        return _instances.getTuple(_orderedInstances[i].first);
     }
+    else
+        return Tuple();
+}
+
+
+// the next tuple is searched in slots after the current index i
+inline Tuple Predicate::nextTrueInstance(int& i, int end_i, const intVector& slots){
+    return firstTrueInstance(i, i + 1, end_i, slots);
+}
+
+
+// only tuples whose index is in slots are considered (slots is in increasing order)
+inline std::pair<Tuple, statusEnum> Predicate::firstSoftInstance(int& i, int begin_i, int end_i, const intVector& slots){
+    intVector::const_iterator it = std::lower_bound(slots.begin(), slots.end(), begin_i);
+    if ((it != slots.end()) && (*it <= end_i)) {
+        i = *it;
+        return std::make_pair(_instances.getTuple(_orderedInstances[i].first), _orderedInstances[i].second);
+    }
+    else
+        return std::make_pair(Tuple(), NO_);
+}
+
+
+// the next tuple is searched in slots after the current index i
+inline std::pair<Tuple, statusEnum> Predicate::nextSoftInstance(int& i, int end_i, const intVector& slots){
+    return firstSoftInstance(i, i + 1, end_i, slots);
 }
 
 
@@ -803,6 +1065,24 @@ inline void Predicate::initDelta(){
 }
 
 
+// put the extension on the trail, if it is its first modification since the last recorded state
+inline void Predicate::trail(){
+    if (_trailStamp != _stamp()) {
+        _trail().push_back(std::make_pair(this, getEndIndex()));
+        _trailStamp = _stamp();
+    }
+}
+
+
+inline void Predicate::addDependencies(){
+    if (Dependencies::tracking()) {
+        _dependencies.resize(_orderedInstances.size() - 1, NULL);
+        _dependencies.push_back(Dependencies::current());
+        Dependencies::added(this, _orderedInstances.size() - 1);
+    }
+}
+
+
 inline bool Predicate::emptyDelta(){
     return (_deltaBegin > _deltaEnd);
 }
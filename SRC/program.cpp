@@ -19,8 +19,19 @@
  ****************************************************************************/  
 
 
+#include <map>
+#include <sstream>
+
+#include "answer_set.hpp"
+#include "func_term.hpp"
 #include "functor.hpp"
+#include "list.hpp"
+#include "num_const.hpp"
 #include "program.hpp"
+#include "parallel_fixpoint.hpp"
+#include "parallel_search.hpp"
+#include "scc_scheduler.hpp"
+#include "snapshot.hpp"
 
 
 
@@ -30,6 +41,17 @@ Program::Program(){
     _answer_number  = 0;
     _choice_points = 0;
     _bad_choice = 0;
+    _batch_propagation = true;
+    _jobs = 1;
+    _fixpoint_jobs = 1;
+    _search_jobs = 1;
+    _ordered_answers = false;
+    _parallel_search = NULL;
+    _backjumping = false;
+    _backjumps = 0;
+    _heuristic = new StaticHeuristic();
+    _snapshot = NULL;
+    _handler = NULL;
 }
 
 
@@ -48,9 +70,12 @@ Program::~Program(){
     for (ruleSet::iterator it = _constraint_rules.begin(); it != _constraint_rules.end(); it++)
         delete (*it);
     _constraint_rules.clear();
+    delete _heuristic;
+    Dependencies::clear();
     Predicate::deleteAll();
     Term::delete_all();
     Functor::deleteAll();
+    List::init();   // for the next program (cf. Solver)
 }
 
 
@@ -80,6 +105,7 @@ void Program::initNonDefiniteRules(){
         }
     }
     initBodyPlusRules();
+    initBodyOrders();
 }
 
 
@@ -93,6 +119,19 @@ void Program::addNonDefiniteRule(int sccIndex, Rule* r){
 }
 
 
+// the rules of scc are reordered in place, so that iterators on _non_definite_rules remain valid
+void Program::orderNonDefiniteRules(int scc){
+    std::pair<ruleMultimap::iterator, ruleMultimap::iterator> range = _non_definite_rules.equal_range(scc);
+    std::vector<Rule*> rules;
+    for (ruleMultimap::iterator it = range.first; it != range.second; ++it)
+        rules.push_back(it->second);
+    _heuristic->order(rules);
+    std::vector<Rule*>::iterator r = rules.begin();
+    for (ruleMultimap::iterator it = range.first; it != range.second; ++it, ++r)
+        it->second = *r;
+}
+
+
 // initialize BodyPlusRules maps of predicates (rules in which the predicate appears in body-)
 void Program::initBodyPlusRules(){
     // definite rules
@@ -106,45 +145,107 @@ void Program::initBodyPlusRules(){
 }
 
 
+// compute the body orders of the rules evaluated by propagateBis,
+// that is, definite rules and definite clones of non-definite and constraint rules
+// (clones of prohibited rules compute their orders when first needed)
+void Program::initBodyOrders(){
+    for (ruleSet::iterator it = _definite_rules.begin(); it != _definite_rules.end(); ++it)
+        (*it)->initBodyOrders();
+    for (ruleMultimap::iterator it = _non_definite_rules.begin(); it != _non_definite_rules.end(); ++it)
+        it->second->getClone()->initBodyOrders();
+    for (ruleSet::iterator it = _constraint_rules.begin(); it != _constraint_rules.end(); ++it)
+        (*it)->getClone()->initBodyOrders();
+}
+
+
 // evaluation of the definite part of the program
+// with several jobs, SCCs whose dependencies are evaluated are dispatched to a pool of threads (cf. SccScheduler)
+// the rules are hashed one by one (FNV-1a on their text) and the hashes are summed :
+// the order of the rule sets depends on addresses
+uint64_t Program::fingerprint(){
+    const uint64_t basis = (static_cast<uint64_t>(0xcbf29ce4) << 32) | 0x84222325;
+    const uint64_t prime = (static_cast<uint64_t>(1) << 40) | 0x1b3;
+    uint64_t h = 0;
+    ruleSet* rules[3] = {&_definite_rules, &_normal_rules, &_constraint_rules};
+    for (int k = 0; k < 3; ++k)
+        for (ruleSet::iterator it = rules[k]->begin(); it != rules[k]->end(); ++it) {
+            std::ostringstream oss;
+            oss << **it;
+            const std::string& text = oss.str();
+            uint64_t r = basis;
+            for (std::string::const_iterator c = text.begin(); c != text.end(); ++c)
+                r = (r ^ static_cast<unsigned char>(*c)) * prime;
+            h += r;
+        }
+    h = h * prime + NumConst::getMaxInt();
+    return h * prime + FuncTerm::getMaxDepth();
+}
+
+
 void Program::evaluate(){
     _graph.computeSCC();
+    if (_jobs > 1) {
+        SccScheduler scheduler(*this);
+        scheduler.run(_jobs);
+        _currentScc = _graph.numberOfScc();
+        return;
+    }
     bool ok = _graph.firstScc(_currentScc);
     while (ok){
         ruleSet recRules;   // recursive rules of current SCC
         ruleSet exitRules;  // exit rules of current SCC
-        Node::Set ns;       // nodes of current SCC
         _graph.getRulesFromScc(_currentScc, recRules, exitRules, *this);
-        _graph.getNodesFromScc(_currentScc, ns);
-        // evaluation of exit rules
-        for (ruleSet::iterator i = exitRules.begin(); i != exitRules.end(); i++) {
-            (*i)->orderBody(ns);
-            (*i)->evaluate();
-        }
-        // evaluation of recursive rules
-        _graph.initDelta(_currentScc);
-        do {
-            for (ruleSet::iterator i = recRules.begin(); i != recRules.end(); i++) {
-				(*i)->orderBody(ns);
-                (*i)->evaluateRec();
-			}
-            _graph.setDelta(_currentScc);
-        } while (! _graph.emptyDelta(_currentScc));
-
+        evaluateScc(_currentScc, recRules, exitRules);
         _graph.setSolvedIfItIsTheCase(_currentScc);
         ok = _graph.nextScc(_currentScc);
     }
 }
 
 
+// evaluation of recRules and exitRules, the definite rules of scc 'index'
+// only predicates of this scc are modified
+void Program::evaluateScc(int index, ruleSet& recRules, ruleSet& exitRules){
+    if (_snapshot && _snapshot->restoreScc(_graph, index))
+        return;
+    Node::Set ns;       // nodes of the SCC
+    _graph.getNodesFromScc(index, ns);
+    // evaluation of exit rules
+    for (ruleSet::iterator i = exitRules.begin(); i != exitRules.end(); i++) {
+        (*i)->orderBody(ns);
+        (*i)->evaluate();
+    }
+    // evaluation of recursive rules
+    _graph.initDelta(index);
+    if ((_fixpoint_jobs > 1) && !recRules.empty()) {
+        ParallelFixpoint fixpoint(_graph, index, recRules, ns, _fixpoint_jobs);
+        do {
+            fixpoint.iterate();
+            _graph.setDelta(index);
+        } while (! _graph.emptyDelta(index));
+    }
+    else
+        do {
+            for (ruleSet::iterator i = recRules.begin(); i != recRules.end(); i++) {
+                (*i)->orderBody(ns);
+                (*i)->evaluateRec();
+            }
+            _graph.setDelta(index);
+        } while (! _graph.emptyDelta(index));
+}
+
+
 // re-evaluation of the definite part of the program after atoms of _atoms_queue are added
-// if propagation leads to contradictory conclusion, restore state before propagation
+// if propagation leads to contradictory conclusion, learn it and restore state before propagation
 bool Program::propagate(Changes& changes){
     try {
         propagateBis(changes);
         return true;    // everything is ok
     }
-    catch (const ContradictoryConclusion&) {
+    catch (const ContradictoryConclusion& e) {
+        Dependencies::refute(e);
+        Dependencies::setConflict(e);
+        _nogoods.learn(e);
+        conflict(e);
         changes.retropropagate(*this);
         return false;   // propagation leads to contradictory conclusion
     }
@@ -152,13 +253,28 @@ bool Program::propagate(Changes& changes){
 
 
 // re-evaluation of the definite part of the program after atoms of _atoms_queue and _not_atoms_queue are added
+// in batch mode, every instance of a predicate is queued when added, so that instances from p_i.second
+// to the end of the extension are all waiting in the queue : they are propagated together as one delta,
+// and their remaining entries in the queue are skipped
 void Program::propagateBis(Changes& changes){
     atomsQueue& aq = changes.getAtomsQueue();
+    std::map<Predicate*, int> propagated;   // last index propagated for each predicate (batch mode)
     std::pair<Predicate*,int> p_i;
+    _nogoods.watchLearned(aq);  // nogoods learned since the last propagation
     while (!aq.empty()){
         p_i = aq.front();   // atom to propagate
         aq.pop();
-        p_i.first->setDelta(p_i.second);
+        if (_batch_propagation) {
+            std::map<Predicate*, int>::iterator last = propagated.insert(std::make_pair(p_i.first, -1)).first;
+            if (p_i.second <= last->second)
+                continue;   // already propagated by a previous batch
+            last->second = p_i.first->getEndIndex();
+            p_i.first->setDelta(p_i.second, last->second);
+        }
+        else
+            p_i.first->setDelta(p_i.second);
+        int begin = p_i.first->getDeltaBeginIndex();
+        int end = p_i.first->getDeltaEndIndex();
         ruleMultimap* rulesm = p_i.first->getBodyPlusDefiniteRules();   // rules whose body+ contains literal with predicate of p_i
         // evaluation of rules
         for (ruleMultimap::iterator i = rulesm->begin(); i != rulesm->end(); i++) {
@@ -167,14 +283,17 @@ void Program::propagateBis(Changes& changes){
         }
         ruleSet* rules = p_i.first->getBodyPlusDefiniteConstraints();   // constraint rules whose body+ contains literal with predicate of p_i
         bool found = false;
+        const decisionSet* ds = NULL;
         ruleSet::iterator it = rules->begin();
         while (it != rules->end() && !found) {
             (*it)->orderBody(p_i.first);    // "recursive literals" are those with predicate p_i.first
-            found = (*it)->existsInstanceDefiniteRuleRec();
+            found = (*it)->existsInstanceDefiniteRuleRec(ds);
             it++;
         }
         if (found)  // a constraint rule is supported and unbloked
-            throw ContradictoryConclusion();
+            throw Dependencies::contradiction(ds);
+        _prohibitions.propagate(p_i.first, begin, end);  // prohibited rules watching the new atoms
+        _nogoods.propagate(p_i.first, begin, end, aq);    // learned nogoods watching the new atoms
     }
 }
 
@@ -291,9 +410,11 @@ bool Program::propagateSolvedPredicates(Changes& changes){
         int nextScc = getNextNonStratifiedScc();    // numberOfScc if there is not
         do {
             ruleSet rset;
+            std::vector<Predicate*> notP;
             _graph.setSolved(true, firstScc);
             _graph.addConstraintsContainingNotP(firstScc, rset);
-            if (_graph.existsMbtInstance(firstScc) || existsSupportedUnblockedRule(rset)) {
+            _graph.addNegatedPredicates(firstScc, notP);
+            if (_graph.existsMbtInstance(firstScc) || existsSupportedUnblockedRule(rset) || _prohibitions.existsViolated(notP)) {
                 throw ContradictoryConclusion();
             }
             else {
@@ -309,7 +430,8 @@ bool Program::propagateSolvedPredicates(Changes& changes){
         changes.recordIntermediarySccExtensions(*this, nextScc);    // record result of propagation
         return true;
     }
-    catch (const ContradictoryConclusion&) {
+    catch (const ContradictoryConclusion& e) {
+        Dependencies::setConflict(e);
         changes.retropropagateSolved(*this, _currentScc, firstScc);
         return false;
     }
@@ -334,6 +456,88 @@ void Program::restoreState(bool& b){
 }
 
 
+// the refuted rule and the rules of the decisions of c are given to the heuristic
+// (before c is retropropagated : its decisions are still known)
+void Program::conflict(const ContradictoryConclusion& c){
+    if (!_heuristic->isDynamic())
+        return;
+    std::vector<Rule*> rules(1, currentNonDefiniteRule());
+    if (Dependencies::tracking() && c.knownDecisions() && c.getDecisions()) {
+        const decisionSet& ds = *c.getDecisions();
+        for (decisionSet::const_iterator it = ds.begin(); it != ds.end(); ++it)
+            rules.push_back(Dependencies::getDecision(*it)._rule);
+    }
+    _heuristic->conflict(rules);
+}
+
+
+// the failure of the search follows from decisions made at lower levels of the back-track stack :
+// the levels above the deepest of them are popped, and their extensions restored in one step
+void Program::backjump(){
+    if (!_backjumping || !Dependencies::knownConflict())
+        return;
+    unsigned int size = Dependencies::conflictLevel() + 1;  // the deepest decision is on the top of the stack
+    if (_chan_bool_stack.size() <= size)
+        return;
+    unwind(size);
+    _backjumps++;
+}
+
+
+// the extensions are restored in one step, then the search state of each popped level, from the top
+bool Program::unwind(unsigned int size){
+    bool b = true;
+    unsigned int states = 0;
+    std::vector<Changes*> popped;
+    while (_chan_bool_stack.size() > size) {
+        Changes* ch = _chan_bool_stack.top().first;
+        b = _chan_bool_stack.top().second;
+        _chan_bool_stack.pop();
+        states += ch->recordedStates();
+        popped.push_back(ch);
+    }
+    Predicate::restoreExtensions(states);
+    for (std::vector<Changes*>::iterator it = popped.begin(); it != popped.end(); ++it) {
+        (*it)->restoreSearch(*this);
+        delete *it;
+    }
+    return b;
+}
+
+
+// the whole stack is popped and the state of the first choice point is recorded again, with the same
+// branch : its right branch is still to be explored if it was not, so that the search remains complete
+// (learned nogoods and the activities of the heuristic are kept)
+Changes* Program::restart(){
+    bool b = unwind(0);
+    _control.restarted(_bad_choice);
+    return recordState(b);
+}
+
+
+bool Program::interrupted(){
+    bool reached = _control.limitReached(_choice_points);
+    if (_control.progressDue())
+        printProgress();
+    return reached;
+}
+
+
+// progress lines are written on the error stream, apart from the answer sets
+void Program::printProgress(){
+    std::cerr << "############### " << _control.getElapsed() << " s : " << _choice_points << " choice points, "
+              << _bad_choice << " bad choices, " << _answer_number << " answer sets";
+    if (_control.isRestarting())
+        std::cerr << ", " << _control.getRestarts() << " restarts";
+    if (_backjumping)
+        std::cerr << ", " << _backjumps << " back-jumps";
+    if (_nogoods.isLearning())
+        std::cerr << ", " << _nogoods.getLearnedNumber() << " learned nogoods, "
+                  << _nogoods.getPropagatedNumber() << " nogood propagations";
+    std::cerr << std::endl;
+}
+
+
 void Program::topState(Changes*& ch){
     if (!_chan_bool_stack.empty()) {
         chanboolPair changes_with = _chan_bool_stack.top();
@@ -349,7 +553,8 @@ bool Program::firstChoicePoint(Changes& changes, bool& stop){
         bool found = firstApplicationOfNonDefiniteRule(changes);
         return choicePoint(changes, stop, found);
     }
-    catch (const ContradictoryConclusion&) {
+    catch (const ContradictoryConclusion& e) {
+        Dependencies::setConflict(e);
         stop = false;
         return false;
     }
@@ -361,7 +566,8 @@ bool Program::nextChoicePoint(Changes& changes, bool& stop){
         bool found = nextApplicationOfNonDefiniteRule(changes);
         return choicePoint(changes, stop, found);
     }
-    catch (const ContradictoryConclusion&) {
+    catch (const ContradictoryConclusion& e) {
+        Dependencies::setConflict(e);
         stop = false;
         return false;
     }
@@ -389,9 +595,17 @@ bool Program::choicePoint(Changes& changes, bool& stop, bool found){
                 }
                 else {  // all scc have been processed
                     end = true; 
+                    Dependencies::setConflict(ContradictoryConclusion());   // go back chronologically to the next answer set
                     _answer_number++;
                     stop = _answer_number == _max_answer_number;
-                    printAnswerSet();
+                    if (_parallel_search)   // worker process
+                        _parallel_search->answerSet();
+                    else if (_handler) {
+                        if (!_handler->answerSet(AnswerSet(_answer_number)))
+                            stop = true;
+                    }
+                    else
+                        printAnswerSet();
                 }
             }
             else {  // propagation leads to contradictory conclusion
@@ -411,6 +625,8 @@ int Program::answerSetSearch(int n){
     _answer_number = 0;
     _choice_points = 0;
     _bad_choice = 0;
+    _backjumps = 0;
+    _control.start();
     // tester si des contraintes ne sont pas violées après évaluation de la partie définie du prg
     ruleSet rset;
     addDefiniteConstraintRules(rset);   // all definite (clone of) constraints
@@ -418,16 +634,24 @@ int Program::answerSetSearch(int n){
         return 0;   // contrainte violée, le prg est UNSAT
 
     initNonDefiniteRules(); // initialize the multimap _non_definite_rules
+    for (ruleMultimap::iterator it = _non_definite_rules.begin(); it != _non_definite_rules.end(); it = _non_definite_rules.upper_bound(it->first))
+        orderNonDefiniteRules(it->first);
     setFirstNonStratifiedScc(); //initialize _currentScc and _current_range
     Changes* changes = new Changes;
     _first_state = changes;
     changes->recordExtensions(*this);
     bool stop;
     bool found = firstChoicePoint(*changes, stop);
+    if (found && (_search_jobs > 1)) {  // subtrees of the first choice point are explored by worker processes
+        ParallelSearch search(*this, _search_jobs, _ordered_answers);
+        _answer_number = search.run(n);
+        delete _first_state;
+        return _answer_number;
+    }
     bool withRule = true;   // true for the left tree branch
     do {
         if (withRule) { // descente gauche
-            while (found) {
+            while (found && !(stop = interrupted())) {
                 // search for an AS with _current_non_definite_rule (applied)
                 _choice_points++;
                 changes = recordState(true);
@@ -435,10 +659,20 @@ int Program::answerSetSearch(int n){
             }
             // stop indique s'il faut poursuivre
         }
+        if (!_chan_bool_stack.empty() && !stop && (_answer_number == 0) && _control.restartDue(_bad_choice)) {
+            // restarts are made before the first answer set, which could be found again otherwise
+            changes = restart();
+            found = nextChoicePoint(*changes, stop);
+            withRule = true;
+            continue;
+        }
+        if (!_chan_bool_stack.empty() && !stop)
+            backjump(); // skip the choice points that are not responsible for the failure
         if (!_chan_bool_stack.empty() && !stop) {
             restoreState(withRule);
             topState(changes);
             if (withRule) { // remontée gauche
+                Dependencies::refute(Dependencies::conflict()); // reason of the prohibition
                 changes->retropropagate(*this); // restore state before propagation
                 // search for an AS without _current_non_definite_rule
                 _bad_choice++;
@@ -454,7 +688,7 @@ int Program::answerSetSearch(int n){
             else {  //remontée droite
             }
         }
-    } while (!_chan_bool_stack.empty() && !stop);
+    } while (!_chan_bool_stack.empty() && !stop && !(stop = interrupted()));
     while (!_chan_bool_stack.empty()) {
         chanboolPair changes_with = _chan_bool_stack.top();
         _chan_bool_stack.pop();
@@ -22,17 +22,29 @@
 #ifndef _PROGRAM_HPP_
 #define _PROGRAM_HPP_
 
+#include <stdint.h>
+
 #include "changes.hpp"
 #include "constraint_rule.hpp"
 #include "definition.hpp"
 #include "graph.hpp"
+#include "heuristic.hpp"
+#include "nogoods.hpp"
 #include "normal_rule.hpp"
+#include "prohibitions.hpp"
 #include "rule.hpp"
+#include "search_control.hpp"
+
 
+class AnswerSetHandler;
+class ParallelSearch;
+class Snapshot;
 
 
 class Program{
 
+    friend class ParallelSearch;
+
 //***************************** MEMBER VARIABLES *****************************//
 
   protected:
@@ -60,6 +72,9 @@ class Program{
 
         ruleSet _prohibited_rules;
 
+        /// definite clones of the prohibited rules, triggered by watched atoms
+        Prohibitions _prohibitions;
+
         int _max_answer_number;
 
         int _answer_number;
@@ -70,11 +85,50 @@ class Program{
 
         int _bad_choice;
 
+        /// true if queued atoms of a same predicate are propagated together (cf. propagateBis)
+        bool _batch_propagation;
+
+        /// number of threads evaluating SCCs of the definite part (cf. evaluate)
+        int _jobs;
+
+        /// number of threads sharing the deltas of a recursive SCC (cf. evaluateScc)
+        int _fixpoint_jobs;
+
+        /// number of worker processes searching for answer sets (cf. answerSetSearch)
+        int _search_jobs;
+
+        /// with _search_jobs, answer sets are printed in the order of the sequential search
+        bool _ordered_answers;
+
+        /// search of the worker process, NULL in the main process
+        ParallelSearch* _parallel_search;
+
+        /// nogoods learned from contradictory conclusions
+        Nogoods _nogoods;
+
+        /// order of the non definite rules of an scc (cf. orderNonDefiniteRules)
+        Heuristic* _heuristic;
+
+        /// true if the search jumps back to the deepest choice point responsible for a failure (cf. backjump)
+        bool _backjumping;
+
+        /// number of back-jumps over at least one choice point
+        int _backjumps;
+
+        /// limits, restarts and progress lines of the search
+        SearchControl _control;
+
         /// back-track stack
         chanboolStack _chan_bool_stack;
 
         Changes* _first_state;
 
+        /// extensions of a previous run restored instead of evaluating sccs (cf. evaluateScc), or NULL
+        Snapshot* _snapshot;
+
+        /// receiver of the answer sets found by the search, NULL to print them
+        AnswerSetHandler* _handler;
+
 
 //******************************* CONSTRUCTORS *******************************//
 
@@ -99,6 +153,23 @@ class Program{
 
         inline int getChoicePoints();
 
+        inline int getBadChoices();
+
+        /// depth of the back-track stack
+        inline int getSearchLevel();
+
+        inline int getLearnedNogoods();
+
+        /// number of atoms excluded by the learned nogoods
+        inline int getNogoodPropagations();
+
+        inline int getBackjumps();
+
+        inline int getRestarts();
+
+        /// limits, restart policy and progress period of the search
+        inline SearchControl& getSearchControl();
+
 
 //********************************** SETTERS *********************************//
 
@@ -110,6 +181,29 @@ class Program{
 
         inline void setVerbosity(int i);
 
+        inline void setBatchPropagation(bool b);
+
+        inline void setJobs(int n);
+
+        inline void setFixpointJobs(int n);
+
+        inline void setSearchJobs(int n);
+
+        inline void setOrderedAnswers(bool b);
+
+        /// learn at most n nogoods (0 : no learning)
+        inline void setNogoods(int n);
+
+        inline void setBackjumping(bool b);
+
+        /// h is owned by the program
+        inline void setHeuristic(Heuristic* h);
+
+        inline void setSnapshot(Snapshot* s);
+
+        /// with a handler, the answer sets of answerSetSearch are given to it instead of being printed
+        inline void setAnswerSetHandler(AnswerSetHandler* h);
+
 
 //********************************* OPERATORS ********************************//
 
@@ -139,7 +233,17 @@ class Program{
 
         void initBodyPlusRules(); 
 
-        inline void addProhibited(Rule* r, Changes& changes);
+        /// order the non definite rules of scc by the heuristic
+        void orderNonDefiniteRules(int scc);
+
+        /// compute once the body orders used by propagateBis
+        void initBodyOrders();
+
+        /// ds : decisions from which the prohibition is derived
+        inline void addProhibited(Rule* r, Changes& changes, const decisionSet* ds);
+
+        /// the prohibited rule of clone is restored
+        inline void removeProhibitedClone(Rule* clone);
 
         inline bool isDefinite();
 
@@ -162,8 +266,14 @@ class Program{
 
         inline bool setPreviousNonStratifiedScc();
 
+        /// hash of the rules (but facts) and of the limits of the terms, independent of the order of the rules
+        uint64_t fingerprint();
+
         void evaluate();
 
+        /// evaluation of recRules and exitRules, the definite rules of scc 'index'
+        void evaluateScc(int index, ruleSet& recRules, ruleSet& exitRules);
+
         bool propagate(Changes& changes);
 
         bool propagateSolvedPredicates(Changes& changes);
@@ -195,10 +305,26 @@ class Program{
 
         void topState(Changes*& ch);
 
+        /// pop the states of the choice points that are not responsible for the last failure
+        void backjump();
+
+        /// the heuristic learns from contradiction c
+        void conflict(const ContradictoryConclusion& c);
+
+        /// go back to the first choice point, return its new state
+        Changes* restart();
+
+        /// true if a limit of the search is reached (cf. SearchControl)
+        bool interrupted();
+
+        void printProgress();
+
         inline void restoreDeltasCurrentScc();
 
         inline void printAnswerSet();
 
+        inline void printAnswerSetHeader();
+
     protected:
         void propagateBis(Changes& changes);
 
@@ -206,6 +332,9 @@ class Program{
 
         bool choicePoint(Changes& changes, bool& stop, bool f);
 
+        /// pop the states of the back-track stack down to size, return the flag of the last popped one
+        bool unwind(unsigned int size);
+
 
 }; // class Program
 
@@ -237,6 +366,41 @@ inline int Program::getChoicePoints(){
 }
 
 
+inline int Program::getBadChoices(){
+    return _bad_choice;
+}
+
+
+inline int Program::getSearchLevel(){
+    return _chan_bool_stack.size();
+}
+
+
+inline int Program::getLearnedNogoods(){
+    return _nogoods.getLearnedNumber();
+}
+
+
+inline int Program::getNogoodPropagations(){
+    return _nogoods.getPropagatedNumber();
+}
+
+
+inline int Program::getBackjumps(){
+    return _backjumps;
+}
+
+
+inline int Program::getRestarts(){
+    return _control.getRestarts();
+}
+
+
+inline SearchControl& Program::getSearchControl(){
+    return _control;
+}
+
+
 //********************************** SETTERS *********************************//
 
 inline void Program::setAnswerNumber(int i){
@@ -257,6 +421,59 @@ inline void Program::setVerbosity(int i) {
   _verbosity = i;
 }
 
+
+inline void Program::setBatchPropagation(bool b){
+    _batch_propagation = b;
+}
+
+
+inline void Program::setNogoods(int n){
+    _nogoods.setLimit(n);
+    Dependencies::setEnabled((n > 0) || _backjumping);
+}
+
+
+inline void Program::setHeuristic(Heuristic* h){
+    delete _heuristic;
+    _heuristic = h;
+}
+
+
+inline void Program::setSnapshot(Snapshot* s){
+    _snapshot = s;
+}
+
+
+inline void Program::setAnswerSetHandler(AnswerSetHandler* h){
+    _handler = h;
+}
+
+
+inline void Program::setBackjumping(bool b){
+    _backjumping = b;
+    Dependencies::setEnabled(_nogoods.isLearning() || b);
+}
+
+
+inline void Program::setJobs(int n){
+    _jobs = n;
+}
+
+
+inline void Program::setFixpointJobs(int n){
+    _fixpoint_jobs = n;
+}
+
+
+inline void Program::setSearchJobs(int n){
+    _search_jobs = n;
+}
+
+
+inline void Program::setOrderedAnswers(bool b){
+    _ordered_answers = b;
+}
+
 //********************************* OPERATORS ********************************//
 
 inline std::ostream& operator << (std::ostream& os, Program& p){
@@ -398,8 +615,11 @@ inline int Program::getNextNonStratifiedScc(){
 
 // update _currentScc and _current_range to the next non locally stratified scc
 // return false if _currentScc was the last one
+// (no state of the search refers to the order of the rules of the next scc, it can be changed)
 inline bool Program::setNextNonStratifiedScc(){
     if (_graph.setNextNonStratifiedScc(_currentScc)) {
+        if (_heuristic->isDynamic())
+            orderNonDefiniteRules(_currentScc);
         _current_range = _non_definite_rules.equal_range(_currentScc);  //rules from the scc
         return true;
     }
@@ -419,18 +639,26 @@ inline bool Program::setPreviousNonStratifiedScc(){
 }
 
 
-inline void Program::addProhibited(Rule* r, Changes& changes){
+inline void Program::addProhibited(Rule* r, Changes& changes, const decisionSet* ds){
     std::pair<ruleSet::iterator, bool> i_b = _prohibited_rules.insert(r);
     if (i_b.second) {   // r was not already prohibited
         changes.addProhibited(r);
         Rule* clone = r->createDefiniteClone(); // creation of a definite clone of constraint rule r
-        clone->getBodyPlus()->addBodyPlusDefiniteConstraint(clone);
+        clone->setDependencies(Dependencies::copy(ds));
+        if (!_prohibitions.add(clone))
+            clone->getBodyPlus()->addBodyPlusDefiniteConstraint(clone);
     }
     else
         delete r;
 }
 
 
+inline void Program::removeProhibitedClone(Rule* clone){
+    if (!_prohibitions.remove(clone))
+        clone->getBodyPlus()->removeBodyPlusDefiniteConstraint(clone);
+}
+
+
 // add to ruleSet all definite (clone of) constraints
 inline void Program::addDefiniteConstraintRules(ruleSet& rset){
     for (ruleSet::iterator it = _constraint_rules.begin(); it != _constraint_rules.end(); ++it)
@@ -456,12 +684,17 @@ inline void Program::restoreDeltasCurrentScc(){
 
 
 inline void Program::printAnswerSet(){
+    printAnswerSetHeader();
+    Predicate::prettyPrintAllInstances();
+    std::cout << std::endl;
+}
+
+
+inline void Program::printAnswerSetHeader(){
     if (_verbosity > 1)
 	std::cout<<"############### Answer set "<< _answer_number<<" ( "<<_choice_points<<" choice points, "<<_bad_choice<< " bad choice)"<<" ###############"<<std::endl;
     else if (_verbosity > 0)
 	std::cout<<"############### Answer set "<< _answer_number<<" ###############"<<std::endl;
-    Predicate::prettyPrintAllInstances();
-    std::cout << std::endl;
 }
 
 
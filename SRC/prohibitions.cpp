@@ -0,0 +1,177 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include "dependencies.hpp"
+#include "predicate.hpp"
+#include "prohibitions.hpp"
+#include "rule.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+Prohibitions::Prohibitions() : _constraints(), _watches(), _occurrences(){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+Prohibitions::~Prohibitions(){
+    for (std::map<Rule*, Constraint*>::iterator it = _constraints.begin(); it != _constraints.end(); ++it)
+        delete it->second;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// an atom that is already in the model is watched only if they all are (the constraint is violated,
+// which is detected as for an indexed clone : when one of its predicates is solved)
+bool Prohibitions::add(Rule* r){
+    Body* body = r->getBodyPlus();
+    if (body->empty())
+        return false;
+    for (Body::iterator it = body->begin(); it != body->end(); ++it)
+        if (!(*it)->isPositiveLiteral())
+            return false;
+    Constraint* c = new Constraint();
+    c->_rule = r;
+    for (Body::iterator it = body->begin(); it != body->end(); ++it)
+        c->_atoms.push_back(std::make_pair((*it)->getPred(), (*it)->getArgs()));
+    c->_watch = 0;
+    rewatch(c);
+    getWatches(c, c->_watch).push_back(c);
+    for (unsigned int i = 0; i < c->_atoms.size(); ++i) {
+        constraintVector& occ = _occurrences[c->_atoms[i].first];
+        if (occ.empty() || (occ.back() != c))
+            occ.push_back(c);
+    }
+    _constraints.insert(std::make_pair(r, c));
+    return true;
+}
+
+
+// constraints are usually removed in the reverse order of their addition (when back-tracking)
+bool Prohibitions::remove(Rule* r){
+    std::map<Rule*, Constraint*>::iterator it = _constraints.find(r);
+    if (it == _constraints.end())
+        return false;
+    Constraint* c = it->second;
+    erase(getWatches(c, c->_watch), c);
+    for (unsigned int i = 0; i < c->_atoms.size(); ++i)
+        erase(_occurrences[c->_atoms[i].first], c);
+    _constraints.erase(it);
+    delete c;
+    return true;
+}
+
+
+void Prohibitions::propagate(Predicate* p, int begin, int end){
+    std::map<Predicate*, watchMap>::iterator w = _watches.find(p);
+    if (w == _watches.end())
+        return;
+    Term::Vector tuple;     // key of the watches (the tuples of the extension are only views on their terms)
+    for (int i = begin; i <= end; ++i) {
+        Tuple t = p->getOrderedInstance(i);
+        tuple.assign(t.begin(), t.end());
+        watchMap::iterator it = w->second.find(tuple);
+        if ((it == w->second.end()) || it->second.empty())
+            continue;
+        constraintVector woken;
+        woken.swap(it->second);
+        Constraint* violated = NULL;
+        for (constraintVector::iterator c = woken.begin(); c != woken.end(); ++c) {
+            if (violated || !rewatch(*c)) {  // kept on its atom, until it is removed from the model
+                if (!violated)
+                    violated = *c;
+                it->second.push_back(*c);
+            }
+            else
+                getWatches(*c, (*c)->_watch).push_back(*c);
+        }
+        if (violated)
+            throw Dependencies::contradiction(getDependencies(violated));
+    }
+}
+
+
+// the watches of the constraints whose watched atom has entered the model are moved
+bool Prohibitions::existsViolated(const std::vector<Predicate*>& preds){
+    for (std::vector<Predicate*>::const_iterator p = preds.begin(); p != preds.end(); ++p) {
+        std::map<Predicate*, constraintVector>::iterator occ = _occurrences.find(*p);
+        if (occ == _occurrences.end())
+            continue;
+        for (constraintVector::iterator it = occ->second.begin(); it != occ->second.end(); ++it) {
+            Constraint* c = *it;
+            if (!inModel(c, c->_watch))
+                continue;
+            unsigned int watch = c->_watch;
+            if (!rewatch(c))
+                return true;
+            erase(getWatches(c, watch), c);
+            getWatches(c, c->_watch).push_back(c);
+        }
+    }
+    return false;
+}
+
+
+bool Prohibitions::inModel(const Constraint* c, unsigned int i){
+    return c->_atoms[i].first->containInstance(*c->_atoms[i].second) != NO_;
+}
+
+
+Prohibitions::constraintVector& Prohibitions::getWatches(const Constraint* c, unsigned int i){
+    const Argument& tuple = *c->_atoms[i].second;
+    return _watches[c->_atoms[i].first][tuple];
+}
+
+
+// the atoms following the watched one are tried first
+bool Prohibitions::rewatch(Constraint* c){
+    unsigned int size = c->_atoms.size();
+    for (unsigned int k = 1; k <= size; ++k) {
+        unsigned int i = (c->_watch + k) % size;
+        if (!inModel(c, i)) {
+            c->_watch = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+const decisionSet* Prohibitions::getDependencies(const Constraint* c){
+    const decisionSet* ds = NULL;
+    if (Dependencies::tracking()) {
+        ds = c->_rule->getDependencies();
+        for (unsigned int i = 0; (i < c->_atoms.size()) && (ds != Dependencies::UNKNOWN); ++i)
+            ds = Dependencies::merge(ds, c->_atoms[i].first->getInstanceDependencies(*c->_atoms[i].second));
+    }
+    return ds;
+}
+
+
+void Prohibitions::erase(constraintVector& v, Constraint* c){
+    for (constraintVector::size_type i = v.size(); i > 0; --i)
+        if (v[i-1] == c) {
+            v.erase(v.begin() + (i - 1));
+            return;
+        }
+}
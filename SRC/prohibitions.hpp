@@ -0,0 +1,130 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _PROHIBITIONS_HPP_
+#define _PROHIBITIONS_HPP_
+
+#include <map>
+#include <vector>
+
+#include "definition.hpp"
+#include "term.hpp"
+
+
+class Argument;
+class Rule;
+
+
+
+/**
+ * Ground constraint rules of the prohibited instances of non definite rules (cf. Program::addProhibited).
+ * The body of such a definite clone is made of ground atoms (not_p(t) for the body- of the instance) :
+ * it is violated when all of them are in the model.
+ * Instead of being evaluated each time an atom of one of their predicates is propagated, each constraint
+ * watches one of its atoms that is not in the model, and is only woken when this atom is added : it then
+ * watches another atom, or it is violated if there is none.
+ * A watch needs not be restored when back-tracking, since an atom out of the model remains out of it.
+ * As the constraints only detect violations (nothing is derived from them), one watch is enough.
+ * An atom not_p(t) may also enter the model without being added, when p is solved (closed world
+ * assumption) : the constraints containing atoms of not_p are then checked by existsViolated.
+ */
+class Prohibitions{
+
+//******************************* NESTED TYPES *******************************//
+
+    protected:
+        class Constraint{
+            public:
+                /// definite clone of the prohibited instance
+                Rule* _rule;
+
+                /// atoms of the body
+                std::vector< std::pair<Predicate*, const Argument*> > _atoms;
+
+                /// index in _atoms of the watched atom
+                unsigned int _watch;
+        };
+
+        typedef std::vector<Constraint*> constraintVector;
+
+        /// constraints watching each tuple of a predicate
+        typedef std::map<Term::Vector, constraintVector> watchMap;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        std::map<Rule*, Constraint*> _constraints;
+
+        std::map<Predicate*, watchMap> _watches;
+
+        /// constraints containing an atom of each predicate, in the order of their addition
+        std::map<Predicate*, constraintVector> _occurrences;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        Prohibitions();
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        ~Prohibitions();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// add the definite clone r of a prohibited instance, return false if its body is not made of ground atoms
+        bool add(Rule* r);
+
+        /// remove r, return false if it has not been added
+        bool remove(Rule* r);
+
+        /// the tuples of index begin to end of p are added to the model : wake the constraints that watch them
+        /// @throw ContradictoryConclusion if a constraint is violated
+        void propagate(Predicate* p, int begin, int end);
+
+        /// true if a constraint containing an atom of a predicate of preds is violated
+        /// (those predicates may have entered the model by the closed world assumption)
+        bool existsViolated(const std::vector<Predicate*>& preds);
+
+    protected:
+        /// true if the i-th atom of c is in the model
+        static bool inModel(const Constraint* c, unsigned int i);
+
+        /// constraints watching the i-th atom of c
+        constraintVector& getWatches(const Constraint* c, unsigned int i);
+
+        /// watch another atom of c that is not in the model (c is not in the watches of its current atom),
+        /// return false if there is none
+        bool rewatch(Constraint* c);
+
+        /// decisions from which c is violated
+        const decisionSet* getDependencies(const Constraint* c);
+
+        static void erase(constraintVector& v, Constraint* c);
+
+
+}; // class Prohibitions
+
+
+
+#endif // _PROHIBITIONS_HPP_
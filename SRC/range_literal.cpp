@@ -26,6 +26,16 @@
 
 //******************************* CONSTRUCTORS *******************************//
 
+RangeLiteral::Expansion::Expansion(Argument& tv)
+ : _ranges(tv.size()), _positions(tv.size(), 0), _tuple(), _size(1){
+    _tuple.resize(tv.size(), NULL);
+    for (unsigned int i = 0; i < tv.size(); ++i) {
+        _ranges[i] = &static_cast<RangeTerm*>(tv[i])->getExpansion();
+        _size *= _ranges[i]->size();
+    }
+}
+
+
 RangeLiteral::RangeLiteral(){}
 
 
@@ -44,34 +54,27 @@ RangeLiteral::~RangeLiteral(){}
 
 // add  all tuples represented by 'tv' to extension of predicate _pred
 // all terms in tv are ground RangeTerms
+// the tuples are streamed from the expansion, room for all of them is made at once
 void RangeLiteral::addInstances(Argument& tv, statusEnum st){
-    std::vector<Argument*>* tuples = expand(tv);
-    for (std::vector<Argument*>::iterator it = tuples->begin(); it != tuples->end(); it++) {
-        switch (st) {
-            case TRUE_ :
-                getPred()->addTrueInstance(**it);
-                break;
-            case MBT_ :
-                getPred()->addMbtInstance(**it);
-                break;
-            default :
-                throw RuntimeExcept("try to add instance with illegal status");
-        }
-        delete (*it);
+    if ((st != TRUE_) && (st != MBT_))
+        throw RuntimeExcept("try to add instance with illegal status");
+    Expansion tuples(tv);
+    getPred()->reserveInstances(tuples.size());
+    for (Argument* tuple = tuples.first(); tuple; tuple = tuples.next()) {
+        if (st == TRUE_)
+            getPred()->addTrueInstance(*tuple);
+        else
+            getPred()->addMbtInstance(*tuple);
     }
-    delete tuples;
 }
 
 
 // add  all tuples represented by 'tv' to extension of predicate _pred
 // all terms in tv are ground RangeTerms
 void RangeLiteral::addNonInstances(Argument& tv){
-    std::vector<Argument*>* tuples = expand(tv);
-    for (std::vector<Argument*>::iterator it = tuples->begin(); it != tuples->end(); it++) {
-        getPred()->addNonInstance(**it);
-        delete (*it);
-    }
-    delete tuples;
+    Expansion tuples(tv);
+    for (Argument* tuple = tuples.first(); tuple; tuple = tuples.next())
+        getPred()->addNonInstance(*tuple);
 }
 
 
@@ -79,50 +82,21 @@ void RangeLiteral::addNonInstances(Argument& tv){
 //  and add index of these tuples in atoms queue aq
 // all terms in tv are ground RangeTerms
 bool RangeLiteral::addInstances(Argument& tv, statusEnum st, atomsQueue& aq){
-    std::vector<Argument*>* tuples = expand(tv);
+    if ((st != TRUE_) && (st != MBT_))
+        throw RuntimeExcept("try to add instance with illegal status");
+    Expansion tuples(tv);
+    getPred()->reserveInstances(tuples.size());
     bool added = false;
-    for (std::vector<Argument*>::iterator it = tuples->begin(); it != tuples->end(); it++) {
-        switch (st) {
-            case TRUE_ :
-                added = (getPred()->addTrueInstance(**it, aq) || added);
-                break;
-            case MBT_ :
-                added = (getPred()->addMbtInstance(**it, aq) || added);
-                break;
-            default :
-                throw RuntimeExcept("try to add instance with illegal status");
-            }
-        delete (*it);
+    for (Argument* tuple = tuples.first(); tuple; tuple = tuples.next()) {
+        if (st == TRUE_)
+            added = (getPred()->addTrueInstance(*tuple, aq) || added);
+        else
+            added = (getPred()->addMbtInstance(*tuple, aq) || added);
     }
-    delete tuples;
     return added;
 }
 
 
-// expand ground RangeTerm vector tv 
-// return all tuples represented by tv
-std::vector<Argument*>* RangeLiteral::expand(Argument& tv){
-    std::vector<Argument*>* tuples = new std::vector<Argument*>();
-    Argument* tuple = new Argument();
-    tuples->push_back(tuple);
-    for (Argument::iterator rt_it = tv.begin(); rt_it != tv.end(); rt_it++) {
-        std::vector<Argument*>* tuples_bis = new std::vector<Argument*>();
-        Term::Vector expansion = dynamic_cast<RangeTerm*>(*rt_it)->getExpansion();
-        for (std::vector<Argument*>::iterator tv_it = tuples->begin(); tv_it != tuples->end(); tv_it++) {
-            for (Term::Vector::iterator t_it = expansion.begin(); t_it != expansion.end(); t_it++) {
-                tuple = new Argument(**tv_it);
-                tuple->push_back(*t_it);
-                tuples_bis->push_back(tuple);
-            }
-            delete (*tv_it);
-        }
-        delete tuples;
-        tuples = tuples_bis;
-    }
-    return tuples;
-}
-
-
 RangeLiteral* RangeLiteral::createPositiveClone(MapVariables& mapVar){
     Argument* tv = cloneArgs(mapVar);
     return (new RangeLiteral(getPred(), tv));
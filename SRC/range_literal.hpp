@@ -32,6 +32,38 @@
  */
 class RangeLiteral : public BasicLiteral {
 
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        /// tuples represented by a ground range atom, enumerated one at a time in a single tuple
+        /// (the last position varies first)
+        class Expansion{
+            public:
+                /// tv contains ground RangeTerms
+                Expansion(Argument& tv);
+
+                /// number of tuples
+                inline size_t size() const;
+
+                /// first tuple, NULL if there is none
+                inline Argument* first();
+
+                /// next tuple, NULL if there is no more ; the previous tuple is overwritten
+                inline Argument* next();
+
+            protected:
+                /// expansion of each range term
+                std::vector<const Term::Vector*> _ranges;
+
+                /// position of the current tuple in each expansion
+                std::vector<unsigned int> _positions;
+
+                Argument _tuple;
+
+                size_t _size;
+        };
+
+
 //******************************* CONSTRUCTORS *******************************//
 
     public:
@@ -67,8 +99,6 @@ class RangeLiteral : public BasicLiteral {
 
         inline bool blindAddNonInstances(Argument&, atomsQueue&);
 
-        std::vector<Argument*>* expand(Argument& tv);
-
         /// idem for the next matching tuple
         inline bool nextTrueMatch();
 
@@ -87,9 +117,6 @@ class RangeLiteral : public BasicLiteral {
         /// no sense for a head literal 
         inline void initDelta();
 
-    private:
-        std::vector<Argument*>& expand(RangeTerm::Vector& tv);
-
     protected:
         /// try to match atom with some tuple of the extension 
         /// of the predicate ; return true if a match is found
@@ -104,6 +131,35 @@ class RangeLiteral : public BasicLiteral {
 
 //************************** OTHER MEMBER FUNCTIONS **************************//
 
+inline size_t RangeLiteral::Expansion::size() const{
+    return _size;
+}
+
+
+inline Argument* RangeLiteral::Expansion::first(){
+    if (_size == 0)
+        return NULL;
+    for (unsigned int i = 0; i < _ranges.size(); ++i) {
+        _positions[i] = 0;
+        _tuple[i] = (*_ranges[i])[0];
+    }
+    return &_tuple;
+}
+
+
+inline Argument* RangeLiteral::Expansion::next(){
+    for (int i = _ranges.size() - 1; i >= 0; --i) {
+        if (++_positions[i] < _ranges[i]->size()) {
+            _tuple[i] = (*_ranges[i])[_positions[i]];
+            return &_tuple;
+        }
+        _positions[i] = 0;
+        _tuple[i] = (*_ranges[i])[0];
+    }
+    return NULL;
+}
+
+
 // not defined for a range literal 
 inline statusEnum RangeLiteral::isInstance(){
     throw RuntimeExcept("test instance for a head range literal");
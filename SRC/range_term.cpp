@@ -24,29 +24,24 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-mapRangeTerm RangeTerm::_mapRangeTerm;
-
-
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 RangeTerm* RangeTerm::new_RangeTerm(Term* lb, Term* rb){
-    mapRangeTerm::iterator it = _mapRangeTerm.find(std::make_pair(lb, rb));
-    if (it != _mapRangeTerm.end())  // already exists
+    mapRangeTerm::iterator it = _mapRangeTerm().find(std::make_pair(lb, rb));
+    if (it != _mapRangeTerm().end())  // already exists
         return (*it).second;
     else {
         RangeTerm* t = new RangeTerm(lb, rb);
-        _mapRangeTerm.insert(std::make_pair(std::make_pair(lb, rb), t));
+        _mapRangeTerm().insert(std::make_pair(std::make_pair(lb, rb), t));
         return t;
     }
 }
 
 
 void RangeTerm::delete_all(){
-    for (mapRangeTerm::iterator it = _mapRangeTerm.begin(); it != _mapRangeTerm.end(); it++)
+    for (mapRangeTerm::iterator it = _mapRangeTerm().begin(); it != _mapRangeTerm().end(); it++)
         delete (*it).second;
-    _mapRangeTerm.clear();
+    _mapRangeTerm().clear();
 }
 
 
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "arguments.hpp"
+#include "context.hpp"
 #include "definition.hpp"
 
 
@@ -44,7 +45,7 @@ class RangeTerm : public Term {
 //************************** STATIC MEMBER VARIABLES *************************//
 
     protected:
-        static mapRangeTerm _mapRangeTerm;
+        static inline mapRangeTerm& _mapRangeTerm();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -101,6 +102,13 @@ class RangeTerm : public Term {
 }; // class RangeTerm
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline mapRangeTerm& RangeTerm::_mapRangeTerm(){
+    return Context::current()->_mapRangeTerm;
+}
+
+
 
 
 
@@ -20,6 +20,7 @@
 
 
 #include "constraint_rule.hpp"
+#include "dependencies.hpp"
 #include "normal_rule.hpp"
 #include "program.hpp"
 #include "rule.hpp"
@@ -118,14 +119,40 @@ void Body::applySubstitutionAndAddNonInstances(Program& p, Changes& ch){
             delete tuple;
         }
     }
-    catch (const ContradictoryConclusion&) {
+    catch (const ContradictoryConclusion& e) {
         delete tuple;
+        Dependencies::refute(e);    // before the decision is restored
         ch.retropropagate(p);
         throw;
     }
 }
 
 
+// merge dependencies of the literals (the body is matched)
+const decisionSet* Body::getDependencies(){
+    const decisionSet* ds = NULL;
+    if (Dependencies::tracking())
+        for (Body::iterator it = begin(); (it != end()) && (ds != Dependencies::UNKNOWN); ++it)
+            ds = Dependencies::merge(ds, (*it)->getDependencies());
+    return ds;
+}
+
+
+// built-in and relational literals are true under the substitution, whatever the model
+bool Body::getAtoms(std::vector<atomType>& atoms){
+    for (Body::iterator it = begin(); it != end(); ++it)
+        if ((*it)->isPositiveLiteral()) {
+            int i = static_cast<BasicLiteral*>(*it)->getCurrentIndex();
+            if (i < 0)
+                return false;
+            atoms.push_back(std::make_pair((*it)->getPred(), i));
+        }
+        else if ((*it)->isNegativeLiteral())
+            return false;
+    return true;
+}
+
+
 // split body into recBody and nonRecBody
 // "recursive" literals are those whose predicate appears as label of a node in ns
 void Body::split(Node::Set& ns, Body& recBody, Body& nonRecBody){
@@ -163,24 +190,68 @@ void Body::split(Body& recBody, Body& nonRecBody){
 
 
 // order bodyPlus, result in ordBody
-// TODO pour l'instant littéraux récursifs en premier
-void Body::orderPlus(Body& recBody, Body& nonRecBody, Body& ordBody){
-    for (Body::iterator it = recBody.begin(); it != recBody.end(); it++)
-        ordBody.addLiteral(*it);    // recursive literals first
-    for (Body::iterator it = nonRecBody.begin(); it != nonRecBody.end(); it++)
-        ordBody.addLiteral(*it);    // and then non-recursive literals 
+// the first recursive literal (the one whose delta is examined first) is put first
+// then the cheapest literal is chosen at each step :
+// - tests (relational, affectation and built-in literals) as soon as their input variables are bound,
+// - then atoms with the smallest estimated number of matches w.r.t. already bound variables
+// without _costBasedOrder, recursive literals first and then non-recursive ones in source order
+void Body::orderPlus(Body& recBody, Body& nonRecBody, Body& ordBody, bool useExtension){
+    if (!_costBasedOrder()) {
+        for (Body::iterator it = recBody.begin(); it != recBody.end(); it++)
+            ordBody.addLiteral(*it);    // recursive literals first
+        for (Body::iterator it = nonRecBody.begin(); it != nonRecBody.end(); it++)
+            ordBody.addLiteral(*it);    // and then non-recursive literals 
+        return;
+    }
+    variableSet bound;
+    Literal::Vector lits;
+    for (Body::iterator it = recBody.begin(); it != recBody.end(); it++) {
+        if (it == recBody.begin()) {
+            ordBody.addLiteral(*it);    // first recursive literal first
+            (*it)->addVariables(bound);
+        }
+        else
+            lits.push_back(*it);
+    }
+    lits.insert(lits.end(), nonRecBody.begin(), nonRecBody.end());
+    ordBody.addOrderedLiterals(lits, bound, useExtension);
 }
 
 
 // order body, result in ordBody
-// TODO pour l'instant littéraux récursifs en premier et litteraux négatifs en dernier
+// negative literals at the end
+// the order of body+ does not depend on the extensions : the same order must be found when the search state is restored
 void Body::order(Body& recBody, Body& nonRecBody, Body& ordBody){
-    orderPlus(recBody, nonRecBody,ordBody);
+    orderPlus(recBody, nonRecBody, ordBody, false);
     for (Body::iterator it = begin(); it !=end(); it++)
         ordBody.addLiteral(*it);    // and  negative literals at the end
 }
 
 
+// add literals of lits, cheapest evaluable one first, knowing that variables of vs are bound
+// if no literal can be evaluated, the remaining ones are added in their order
+void Body::addOrderedLiterals(Literal::Vector& lits, variableSet& vs, bool useExtension){
+    while (!lits.empty()) {
+        Literal::Vector::iterator best = lits.end();
+        double bestCost = 0;
+        for (Literal::Vector::iterator it = lits.begin(); (it != lits.end()) && (lits.size() > 1); ++it) {
+            if ((*it)->isEvaluable(vs)) {
+                double cost = (*it)->estimateMatches(vs, useExtension);
+                if ((best == lits.end()) || (cost < bestCost)) {
+                    best = it;
+                    bestCost = cost;
+                }
+            }
+        }
+        if (best == lits.end())
+            best = lits.begin();
+        addLiteral(*best);
+        (*best)->addVariables(vs);
+        lits.erase(best);
+    }
+}
+
+
 // initalisation of previous and free vars for each literal
 void Body::initVars(){
     variableSet ruleVars;
@@ -226,13 +297,17 @@ void Body::addPositiveClone(Body& b, MapVariables& mapVar){
 //******************************* CONSTRUCTORS *******************************//
 
 Rule::Rule(){
+    _number = _created()++;
     _bodyMinus = new Body();
     _bodyPlus = new Body();
     _clone = NULL;
+    _orderedFor = NULL;
+    _head_buffer = NULL;
+    _dependencies = NULL;
 }
 
 
-Rule::Rule(BasicLiteral* a, Body* v) : _head(a), _body(v), _clone(NULL){
+Rule::Rule(BasicLiteral* a, Body* v) : _number(_created()++), _head(a), _body(v), _clone(NULL), _orderedFor(NULL), _head_buffer(NULL), _dependencies(NULL){
     _bodyMinus = new Body();
     _bodyPlus = new Body();
     for (Body::iterator it = v->begin(); it != v->end(); it++) {
@@ -246,7 +321,7 @@ Rule::Rule(BasicLiteral* a, Body* v) : _head(a), _body(v), _clone(NULL){
 
 
 Rule::Rule(BasicLiteral* a, Body* v, const variableSet& s, Graph& g) throw (LogicExcept)
-try : _head(a), _body(v), _variables(s), _clone(NULL) {
+try : _number(_created()++), _head(a), _body(v), _variables(s), _clone(NULL), _orderedFor(NULL), _head_buffer(NULL), _dependencies(NULL) {
     _bodyMinus = new Body();
     _bodyPlus = new Body();
     for (Body::iterator it = v->begin(); it != v->end(); it++) {
@@ -313,6 +388,7 @@ Rule::~Rule(){
         delete *i;
     _variables.clear();
     delete _clone;
+    Dependencies::release(_dependencies);
 }
 
 
@@ -326,58 +402,97 @@ void Rule::clear(){
 }
 
 
-// ordonnancement du corps de la règle TODO (pour l'instant, littéraux "récursifs" en 1er)
+// ordonnancement du corps de la règle (cf. Body::orderPlus)
 // initialisation des atomes recursifs _recursiveBody
 // et initialisation des previous et free vars
 void Rule::orderBody(Node::Set& ns){
     Body nonRecBody;
+    unsetBodyOrder();
     _orderedBody.clear();
     _recursiveBody.clear();
     _bodyPlus->split(ns, _recursiveBody, nonRecBody);
     _bodyPlus->orderPlus(_recursiveBody, nonRecBody, _orderedBody);
     nonRecBody.clear();
     _orderedBody.initVars();
+    compilePlan();
 }
 
 
 // at least one instance of predicate pred has been added to its extension
 //
-// ordonnancement du corps de la règle TODO (pour l'instant, littéraux "récursifs" en 1er)
+// ordonnancement du corps de la règle (cf. Body::orderPlus)
 // initialisation of _recursiveBody with literals whose predicate is pred
 // and initialisation of previous and free vars
+// the order is computed once for each predicate and then reused from _bodyOrders
 void Rule::orderBody(Predicate* pred){
-    Body nonRecBody;
-    _orderedBody.clear();
-    _recursiveBody.clear();
-    _bodyPlus->split(pred, _recursiveBody, nonRecBody);
-    _bodyPlus->orderPlus(_recursiveBody, nonRecBody, _orderedBody);
-    nonRecBody.clear();
-    _orderedBody.initVars();
+    if (_orderedFor == pred)    // already in _orderedBody
+        return;
+    BodyOrderMap::iterator it = _bodyOrders.find(pred);
+    if (it == _bodyOrders.end()) {
+        Body nonRecBody;
+        _orderedBody.clear();
+        _recursiveBody.clear();
+        _bodyPlus->split(pred, _recursiveBody, nonRecBody);
+        _bodyPlus->orderPlus(_recursiveBody, nonRecBody, _orderedBody);
+        nonRecBody.clear();
+        _orderedBody.initVars();
+        compilePlan();
+        BodyOrder& order = _bodyOrders[pred];
+        order._orderedBody = _orderedBody;
+        order._recursiveBody = _recursiveBody;
+        for (Body::iterator i = _orderedBody.begin(); i != _orderedBody.end(); i++) {
+            order._free_vars.push_back((*i)->getFreeVars());
+            order._previous_vars.push_back((*i)->getPreviousVars());
+        }
+        order._plan = _plan;
+    }
+    else {
+        BodyOrder& order = it->second;
+        _orderedBody.assign(order._orderedBody.begin(), order._orderedBody.end());
+        _recursiveBody.assign(order._recursiveBody.begin(), order._recursiveBody.end());
+        for (unsigned int i = 0; i < _orderedBody.size(); i++)
+            _orderedBody[i]->setVars(order._free_vars[i], order._previous_vars[i]);
+        _plan = order._plan;
+    }
+    _orderedFor = pred;
+}
+
+
+// compute body orders for each predicate of body+
+// (rules are ordered w.r.t. the extensions of their predicates at this time)
+void Rule::initBodyOrders(){
+    for (Body::iterator it = _bodyPlus->begin(); it != _bodyPlus->end(); it++)
+        if ((*it)->isPositiveLiteral())
+            orderBody((*it)->getPred());
 }
 
 
-// ordonnancement du corps de la règle TODO (pour l'instant, littéraux "récursifs" en 1er et négatifs en dernier)
+// ordonnancement du corps de la règle (cf. Body::order)
 // initialisation of _recursiveBody with literals which are nor already solved
 // and initialisation of previous and free vars
 void Rule::orderBody(){
     Body nonRecBody;
+    unsetBodyOrder();
     _orderedBody.clear();
     _recursiveBody.clear();
     _bodyPlus->split(_recursiveBody, nonRecBody);
     _bodyMinus->order(_recursiveBody, nonRecBody, _orderedBody);
     nonRecBody.clear();
     _orderedBody.initVars();
+    compilePlan();
 }
 
 
-// ordonnancement du corps de la règle TODO ()
+// ordonnancement du corps de la règle
 // initialisation of _recursiveBody with empty set
 // and initialisation of previous and free vars
 void Rule::orderPositiveBody(){
+    unsetBodyOrder();
     _orderedBody.clear();
     _recursiveBody.clear();
-    _orderedBody = *_bodyPlus;
+    _bodyPlus->orderPlus(_recursiveBody, *_bodyPlus, _orderedBody);
     _orderedBody.initVars();
+    compilePlan();
 }
 
 
@@ -391,7 +506,6 @@ bool Rule::recursive(Node::Set& ns){
 // evaluation of a non-definite rule (search for a "true" supported and non-blocked instance)
 // recursive literals are non-solved one
 bool Rule::firstInstanceNonDefiniteRule(){
-    Literal* lit = firstLiteral();
     Literal* recLit = NULL;
     setSolved(_recursiveBody.empty());  // rule is solved if all body+ literals are solved
     if (!isSolved()) {
@@ -400,83 +514,45 @@ bool Rule::firstInstanceNonDefiniteRule(){
         recLit->setMark(MARKED);
     } else
         initMarks(MARKED);  //"exit" rule : to examine only one time
-    bool matchFound = lit->firstTrueMatch();
-    matchFound = trueInstanceNonDefiniteRule(lit, recLit, matchFound);
-    return matchFound;
+    return trueInstanceNonDefiniteRule(recLit, _plan.first());
 }
 
 
 // evaluation of a non-definite rule
 bool Rule::nextInstanceNonDefiniteRule(){
-    Literal* lit = currentLiteral();
     Literal* recLit = NULL;
     if (!isSolved())
         recLit = recursiveLiteral();    // current non solved literal
-    lit->free();
-    bool matchFound = lit->nextTrueMatch();
-    matchFound = trueInstanceNonDefiniteRule(lit, recLit, matchFound);
-    return matchFound;
+    return trueInstanceNonDefiniteRule(recLit, _plan.next());
 }
 
 
 // search for a "true" supported and non-blocked instance of a non-definite rule
-// lit is the  current literal
 // recLit is the current non solved literal
-// matchFound is true iff a match is found for literal lit
-bool Rule::trueInstanceNonDefiniteRule(Literal* lit, Literal* recLit, bool matchFound){
-    do {
-        if (matchFound) {
-            if ((lit = nextLiteral()))  // NULL if it was the last one
-                matchFound = lit->firstTrueMatch();
-            else {
-                // lit is NULL
-                // a substitution that makes the rule supported and non-blocked is found
-            }
-        }
-        else if ((lit = previousLiteral())) {   // NULL if it was the first one
-            lit->free();
-            matchFound = lit->nextTrueMatch();
-        }
-        else if (!isSolved()) {
-            recLit->setMark(UNMARKED);
-            if ((recLit = nextRecursiveLiteral())) {
-                lit = firstLiteral(); 
-                recLit->setMark(MARKED);    // next recursive literal
-                matchFound = lit->firstTrueMatch();
-            }
-        }
-    } while (lit);
+// matchFound is true iff a match of the body is found with the marks of recLit
+// when there is no more match, the next recursive literal is marked
+bool Rule::trueInstanceNonDefiniteRule(Literal* recLit, bool matchFound){
+    while (!matchFound && !isSolved()) {
+        recLit->setMark(UNMARKED);
+        if (!(recLit = nextRecursiveLiteral()))
+            break;
+        recLit->setMark(MARKED);    // next recursive literal
+        matchFound = _plan.first();
+    }
     return matchFound;
 }
 
 
 // search for a "soft"(true or mbt) supported and non-blocked instance of a non-definite rule
-// lit is the  current literal
-// recLit is the current non solved literal
-// matchStatus is the match status for literal lit (no match, mbt match, or true match)
-statusEnum Rule::softInstanceNonDefiniteRule(Literal* lit, Literal* recLit, statusEnum matchStatus){
-    do {
-        if (matchStatus) {  // a match is found for lit
-            if ((lit = nextLiteral()))  // NULL if it was the last one
-                matchStatus = lit->firstSoftMatch(matchStatus);
-            else {
-                // lit is NULL
-                // a substitution that makes the rule supported and non-blocked is found
-            }
-        }
-        else if ((lit = previousLiteral())) {   // NULL if it was the first one
-            lit->free();
-            matchStatus = lit->nextSoftMatch(previousStatus());
-        }
-        else if (!isSolved()) {
-            recLit->setMark(UNMARKED);
-            if ((recLit = nextRecursiveLiteral())) {
-                lit = firstLiteral(); 
-                recLit->setMark(MARKED);    // next recursive literal
-                matchStatus = lit->firstSoftMatch(TRUE_);
-            }
-        }
-    } while (lit);
+// idem trueInstanceNonDefiniteRule, matchStatus is the match status of the body (no match, mbt match, or true match)
+statusEnum Rule::softInstanceNonDefiniteRule(Literal* recLit, statusEnum matchStatus){
+    while (!matchStatus && !isSolved()) {
+        recLit->setMark(UNMARKED);
+        if (!(recLit = nextRecursiveLiteral()))
+            break;
+        recLit->setMark(MARKED);    // next recursive literal
+        matchStatus = _plan.firstSoft();
+    }
     return matchStatus;
 }
 
@@ -484,19 +560,11 @@ statusEnum Rule::softInstanceNonDefiniteRule(Literal* lit, Literal* recLit, stat
 // search for a "true" supported and non blocked instance of a non-definite rule (constraint rule)
 // there is no "recursive literals" : all predicates are solved 
 bool Rule::existsInstanceNonDefiniteRule(){
-    Literal* lit = firstLiteral();
-    Literal* recLit = NULL;
     setSolved(true);    // all rules are considered  solved 
     initMarks(MARKED);  //rule have to be examined only one time (new instances can not appear)
-    bool matchFound = lit->firstTrueMatch();
-    matchFound = trueInstanceNonDefiniteRule(lit, recLit, matchFound);
-    if (matchFound) {   // free bindings for rule variables
-        lit = currentLiteral();
-        do {
-            lit->free();
-            lit = previousLiteral();
-        } while (lit);
-    }
+    bool matchFound = trueInstanceNonDefiniteRule(NULL, _plan.first());
+    if (matchFound)     // free bindings for rule variables
+        _plan.release();
     return matchFound;
 }
 
@@ -505,19 +573,11 @@ bool Rule::existsInstanceNonDefiniteRule(){
 //  corresponding to a supported and  unblocked instance of a constraint rule
 // there is no "recursive literals" (the only new fact is that some predicate is solved)
 bool Rule::existsInstanceDefiniteConstraint(){
-    Literal* lit = firstLiteral();
-    Literal* recLit = NULL;
     setSolved(true);    // all rules are considered  solved 
     initMarks(NON_MARKED);  //rule have to be examined only one time (new instances can not appear)
-    statusEnum matchStatus = lit->firstSoftMatch(TRUE_);
-    matchStatus = softInstanceNonDefiniteRule(lit, recLit, matchStatus);
-    if (matchStatus) {  // free bindings for rule variables
-        lit = currentLiteral();
-        do {
-            lit->free();
-            lit = previousLiteral();
-        } while (lit);
-    }
+    statusEnum matchStatus = softInstanceNonDefiniteRule(NULL, _plan.firstSoft());
+    if (matchStatus)    // free bindings for rule variables
+        _plan.release();
     return matchStatus;
 }
 
@@ -525,20 +585,15 @@ bool Rule::existsInstanceDefiniteConstraint(){
 // search for a "soft" supported instance of a clone rule (constraint rule) 
 //  corresponding to a supported and  unblocked instance of a constraint rule
 // recursive literals are those whose body+ contains a predicate whose extension has been modified (or a predicate that became solved) 
-bool Rule::existsInstanceDefiniteRuleRec(){
+bool Rule::existsInstanceDefiniteRuleRec(const decisionSet*& ds){
     initMarks(NON_MARKED);//
-    Literal* lit = firstLiteral();
     Literal* recLit = firstRecursiveLiteral();
     recLit->setMark(MARKED);
     setSolved(false);   // recursive body is not empty
-    statusEnum matchStatus = lit->firstSoftMatch(TRUE_);
-    matchStatus = softInstanceNonDefiniteRule(lit, recLit, matchStatus);
+    statusEnum matchStatus = softInstanceNonDefiniteRule(recLit, _plan.firstSoft());
     if (matchStatus) {  // free bindings for rule variables
-        lit = currentLiteral();
-        do {
-            lit->free();
-            lit = previousLiteral();
-        } while (lit);
+        ds = Dependencies::merge(_dependencies, _body->getDependencies());
+        _plan.release();
     }
     return matchStatus;
 }
@@ -552,16 +607,20 @@ ConstraintRule* Rule::createInstance(){
 }
 
 
+// the whole subtree of the instance has failed : the reason of the prohibition comes
+// from the conflict of this failure, if it is known (cf. Program::answerSetSearch)
 void Rule::prohibiteCurrentInstanceOfNDR(Program& p, Changes& ch){
+    const decisionSet* reason = Dependencies::takeReason();
     Literal* l = getBodyMinus()->isSingleLiteral();
     if (l) {    // single literal (not a) body-, add a to MBT atoms
+        Dependencies::Scope scope(reason);
         l = l->createInstance();
         l->addInstances(*l->getArgs(), MBT_, ch.getAtomsQueue());
         delete l;
     }
     else {
         ConstraintRule* r = createInstance();
-        p.addProhibited(r, ch);
+        p.addProhibited(r, ch, reason);
     }
 }
 
@@ -569,26 +628,37 @@ void Rule::prohibiteCurrentInstanceOfNDR(Program& p, Changes& ch){
 // the same as 'prohibiteCurrentInstanceOfNDR' but propagate if MBT atom added 
 // and thus, throw ContradictoryConclusion, or record extensions
 void Rule::prohibiteCurrentInstanceOfNDRWhenSearchingForChoicePoint(Program& p, Changes& ch){
+    const decisionSet* reason = Dependencies::takeReason();
     Literal* l = getBodyMinus()->isSingleLiteral();
     if (l) {    // single literal (not a) body-, add a to MBT atoms
-        l = l->createInstance();
-        l->addInstances(*l->getArgs(), MBT_, ch.getAtomsQueue());
-        delete l;
+        {
+            Dependencies::Scope scope(reason);
+            l = l->createInstance();
+            l->addInstances(*l->getArgs(), MBT_, ch.getAtomsQueue());
+            delete l;
+        }
         // propagate MBT atom added
         if (p.propagate(ch))    // propagation ok, record new extensions
             ch.recordIntermediaryMbtExtensions(p);
         else    // propagation leads to contradiction
-            throw ContradictoryConclusion();
+            throw Dependencies::conflict();
     }
     else {
         ConstraintRule* r = createInstance();
-        p.addProhibited(r, ch);
+        p.addProhibited(r, ch, reason);
     }
 }
 
 
 // create a new definite rule by cloning
 Rule* Rule::createDefiniteClone(){
+    _clone = createDefiniteCopy();
+    return _clone;
+}
+
+
+// create a new definite rule by cloning, which is not recorded as the clone of this rule
+Rule* Rule::createDefiniteCopy(){
     // creation of new variables
     MapVariables mapVar;
     for (variableSet::iterator i = _variables.begin(); i != _variables.end(); i++) {
@@ -602,8 +672,7 @@ Rule* Rule::createDefiniteClone(){
     Body* b = new Body();
     _bodyPlus->addPositiveClone(*b, mapVar);
     _bodyMinus->addPositiveClone(*b, mapVar);
-    _clone = new NormalRule(h, b);
-    return _clone;
+    return new NormalRule(h, b);
 }
 
 
@@ -649,8 +718,8 @@ void Rule::recordCurrentInstanceNDR(){
 // restore all what we need to recover previous search'state
 void Rule::restorePreviousInstanceNDR(){
     // les deltas des littéraux ont déjà été restaurés
-    orderBody();    // (re)initialise _orderedBody, _recursiveBody, previous et free vars
-    _currentLiteral = --_orderedBody.end(); // require _orderedBody not empty
+    orderBody();    // (re)initialise _orderedBody, _recursiveBody, previous et free vars, and the plan
+    _plan.last();   // require _orderedBody not empty
     _recursiveLiteral = _recLit_stack.top();
     _recLit_stack.pop();
     _solved = _solved_stack.top();
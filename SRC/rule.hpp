@@ -23,13 +23,17 @@
 #define _RULE_HPP_
 
 #include <algorithm>
+#include <map>
 #include <stack>
 
 #include "changes.hpp"
+#include "context.hpp"
 #include "definition.hpp"
+#include "dependencies.hpp"
 #include "literal.hpp"
 #include "negative_literal.hpp"
 #include "positive_literal.hpp"
+#include "rule_plan.hpp"
 
 
 class ConstraintRule;
@@ -50,15 +54,27 @@ class Body : public Literal::Vector{
         typedef std::stack<Body::iterator> IteratorStack;
 
 
-//***************************** MEMBER VARIABLES *****************************//
+//************************** STATIC MEMBER VARIABLES *************************//
 
     protected:
+        /// true if the bodies of the current context (cf. Context) are ordered by estimated costs,
+        /// false for recursive literals first and then source order
+        static inline bool& _costBasedOrder();
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
         variableSet _variables;
 
 
-//******************************** DESTRUCTOR ********************************//
+//************************** STATIC MEMBER FUNCTIONS *************************//
 
     public:
+        static inline void setCostBasedOrder(bool b);
+
+
+//******************************** DESTRUCTOR ********************************//
+
         virtual ~Body();
 
 
@@ -109,10 +125,14 @@ class Body : public Literal::Vector{
         /// "recursive" literals are those which are not already solved
         void split(Body& recBody, Body& nonRecBody);
 
-        void orderPlus(Body& recBody, Body& nonRecBody, Body& ordBody);
+        /// useExtension : estimate costs with the current size of extensions
+        void orderPlus(Body& recBody, Body& nonRecBody, Body& ordBody, bool useExtension = true);
 
         void order(Body& recBody, Body& nonRecBody, Body& ordBody);
 
+        /// add literals of lits, cheapest evaluable one first, knowing that variables of vs are bound
+        void addOrderedLiterals(Literal::Vector& lits, variableSet& vs, bool useExtension);
+
         void initVars();
 
         /// create a new body by applying current substitution
@@ -130,6 +150,9 @@ class Body : public Literal::Vector{
         /// restore delta indexes of literals of the body
         inline void restoreDeltas();
 
+        /// literals match only part number 'part' of 'parts' parts of their delta when marked
+        inline void setDeltaPart(int part, int parts);
+
         /// record marks of literals of the body
         inline void recordMarks();
 
@@ -147,10 +170,29 @@ class Body : public Literal::Vector{
 
         inline bool isSolved();
 
+        /// decisions from which the current instance of the body is derived
+        const decisionSet* getDependencies();
+
+        /// add the atoms of the current instance of the positive literals to atoms (the body is matched),
+        /// return false if one of them has no index in its extension
+        bool getAtoms(std::vector<atomType>& atoms);
+
 
 }; // class Body
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline bool& Body::_costBasedOrder(){
+    return Context::current()->_costBasedOrder;
+}
+
+
+inline void Body::setCostBasedOrder(bool b){
+    _costBasedOrder() = b;
+}
+
+
 //********************************** GETTERS *********************************//
 
 inline variableSet& Body::getVariables(){
@@ -229,6 +271,12 @@ inline void Body::restoreDeltas(){
 }
 
 
+inline void Body::setDeltaPart(int part, int parts){
+    for (Body::iterator it = begin(); it != end(); it++)
+        (*it)->setDeltaPart(part, parts);
+}
+
+
 // record marks of literals of the body
 inline void Body::recordMarks(){
     for (Body::iterator it = begin(); it != end(); it++)
@@ -295,10 +343,35 @@ class Rule{
     public:
 //         typedef std::set<Rule*> Set;
 
+        /// head tuples derived by evaluateRec, with the number of the recursive literal that was marked
+        typedef std::vector< std::pair<int, Argument*> > HeadBuffer;
+
+    protected:
+        /// body order of the rule when new instances of a given predicate are propagated,
+        /// with free and previous vars of each literal of this order
+        class BodyOrder{
+            public:
+                Literal::Vector _orderedBody;
+                Literal::Vector _recursiveBody;
+                std::vector<variableSet> _free_vars;
+                std::vector<variableSet> _previous_vars;
+                RulePlan _plan;
+        };
+
+        typedef std::map<Predicate*, BodyOrder> BodyOrderMap;
+
+
+//************************** STATIC MEMBER VARIABLES *************************//
+
+        /// number of rules created
+        static inline int& _created();
+
 
 //***************************** MEMBER VARIABLES *****************************//
 
-    protected:
+        /// creation number of the rule : rules of the program are numbered in source order
+        int _number;
+
         BasicLiteral* _head;
 
         Body* _body;
@@ -313,8 +386,8 @@ class Rule{
 
         Body _orderedBody;
 
-        /// current literal of _orderedBody
-        Body::iterator _currentLiteral;
+        /// execution plan of _orderedBody
+        RulePlan _plan;
 
         /// recursive literals of _orderedBody
         Body _recursiveBody;
@@ -334,6 +407,18 @@ class Rule{
         /// back-track stack for _solved property
         boolStack _solved_stack;
 
+        /// body orders already computed by orderBody(Predicate*)
+        BodyOrderMap _bodyOrders;
+
+        /// predicate whose body order is currently in _orderedBody, NULL if none
+        Predicate* _orderedFor;
+
+        /// if not NULL, evaluateRec adds derived head tuples to this buffer instead of the extension
+        HeadBuffer* _head_buffer;
+
+        /// decisions from which a prohibited instance is derived (cf. Dependencies), NULL for a rule of the program
+        const decisionSet* _dependencies;
+
 
 //******************************* CONSTRUCTORS *******************************//
 
@@ -362,14 +447,16 @@ class Rule{
 
         inline Body* getBodyMinus();
 
-        inline Literal* currentLiteral();
-
         inline Literal* recursiveLiteral();
 
         inline bool isSolved();
 
         inline Rule* getClone();
 
+        inline const decisionSet* getDependencies();
+
+        inline int getNumber();
+
 
 //********************************** SETTERS *********************************//
 
@@ -377,6 +464,14 @@ class Rule{
 
         inline void setClone(Rule* r);
 
+        inline void setHeadBuffer(HeadBuffer* b);
+
+        /// ds is owned by the rule (cf. Dependencies::copy)
+        inline void setDependencies(const decisionSet* ds);
+
+        /// positive literals match only part number 'part' of 'parts' parts of their delta when marked
+        inline void setDeltaPart(int part, int parts);
+
 
 //********************************* OPERATORS ********************************//
 
@@ -397,6 +492,9 @@ class Rule{
 
         void orderBody(Predicate* pred);
 
+        /// compute body orders for each predicate of body+
+        void initBodyOrders();
+
         virtual void orderBody();
 
         virtual void orderPositiveBody();
@@ -407,21 +505,14 @@ class Rule{
         /// true if the rule is recursive r.t. SCC ns
         bool recursive(Node::Set& ns);
 
-        /// can not be NULL
-        inline Literal* firstLiteral();
-
-        inline Literal* nextLiteral();
-
-        inline Literal* previousLiteral();
+        /// _orderedBody has been changed and is no more the body order of _orderedFor
+        inline void unsetBodyOrder();
 
         /// can not be NULL
         inline Literal* firstRecursiveLiteral();
 
         inline Literal* nextRecursiveLiteral();
 
-        /// previous match status
-        inline statusEnum previousStatus();
-
         virtual inline void evaluate();
 
         virtual inline void evaluateRec();
@@ -443,7 +534,8 @@ class Rule{
         virtual bool existsInstanceDefiniteConstraint();
 
         /// TODO non défini pour facts 
-        virtual bool existsInstanceDefiniteRuleRec();
+        /// ds : decisions from which the instance found is derived
+        virtual bool existsInstanceDefiniteRuleRec(const decisionSet*& ds);
 
         /// apply substitution and add head to the model  TODO non défini pour facts et constraints
         virtual inline bool addHead(Program&,Changes&);
@@ -461,6 +553,9 @@ class Rule{
         /// create a new definite rule by cloning
         virtual Rule* createDefiniteClone();
 
+        /// create a new definite rule by cloning, which is not recorded as the clone of this rule
+        Rule* createDefiniteCopy();
+
         void shiftLocallySolvedLiteralsFromBMinus2BPlus(int sccIndex);
 
         /// init atoms iterators in predicate extensions
@@ -489,16 +584,26 @@ class Rule{
     protected:
         virtual std::ostream& put(std::ostream&);
 
+        /// compile the execution plan of _orderedBody, whose free and previous vars are set
+        inline void compilePlan();
+
         /// search for a true supported and non-blocked instance of a non-definite rule
-        bool trueInstanceNonDefiniteRule(Literal* lit, Literal* recLit, bool matchFound);
+        bool trueInstanceNonDefiniteRule(Literal* recLit, bool matchFound);
 
         /// search for a "soft" supported (true or mbt) and non-blocked instance of a non-definite rule
-        statusEnum softInstanceNonDefiniteRule(Literal* lit, Literal* recLit, statusEnum matchFound);
+        statusEnum softInstanceNonDefiniteRule(Literal* recLit, statusEnum matchFound);
 
 
 }; // class Rule
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline int& Rule::_created(){
+    return Context::current()->_created;
+}
+
+
 //********************************** GETTERS *********************************//
 
 inline BasicLiteral* Rule::getHead(){
@@ -521,11 +626,6 @@ inline Body* Rule::getBodyMinus(){
 }
 
 
-inline Literal* Rule::currentLiteral(){
-    return *_currentLiteral;
-}
-
-
 inline Literal* Rule::recursiveLiteral(){
     return *_recursiveLiteral;
 }
@@ -541,6 +641,16 @@ inline Rule* Rule::getClone(){
 }
 
 
+inline const decisionSet* Rule::getDependencies(){
+    return _dependencies;
+}
+
+
+inline int Rule::getNumber(){
+    return _number;
+}
+
+
 inline bool Rule::isNormalRule(){
     return true;
 }
@@ -558,6 +668,22 @@ inline void Rule::setClone(Rule* r){
 }
 
 
+inline void Rule::setHeadBuffer(HeadBuffer* b){
+    _head_buffer = b;
+}
+
+
+inline void Rule::setDependencies(const decisionSet* ds){
+    Dependencies::release(_dependencies);
+    _dependencies = ds;
+}
+
+
+inline void Rule::setDeltaPart(int part, int parts){
+    _bodyPlus->setDeltaPart(part, parts);
+}
+
+
 //********************************* OPERATORS ********************************//
 
 inline std::ostream& operator << (std::ostream& os, Rule& r){
@@ -593,20 +719,9 @@ inline void Rule::free(){
 }
 
 
-// require _orderedBody not empty
-inline Literal* Rule::firstLiteral(){
-    _currentLiteral = _orderedBody.begin();
-    return *_currentLiteral;
-}
-
-
-inline Literal* Rule::nextLiteral(){
-    if (++_currentLiteral != _orderedBody.end())
-        return *_currentLiteral;
-    else {
-        _currentLiteral--;
-        return NULL;
-    }
+// the next call to orderBody(Predicate*) will install its body order again
+inline void Rule::unsetBodyOrder(){
+    _orderedFor = NULL;
 }
 
 
@@ -627,25 +742,6 @@ inline Literal* Rule::nextRecursiveLiteral(){
 }
 
 
-inline Literal* Rule::previousLiteral(){
-    if (_currentLiteral != _orderedBody.begin())
-        return *(--_currentLiteral);
-    else
-        return NULL;
-}
-
-
-// previous match status
-inline statusEnum Rule::previousStatus(){
-    if (_currentLiteral != _orderedBody.begin()) {
-        Body::iterator it = _currentLiteral;
-        return (*--it)->getStatus();
-    }
-    else
-        return TRUE_;   // no previous status
-}
-
-
 inline void Rule::evaluate(){}
 
 
@@ -670,6 +766,11 @@ inline bool Rule::addBodyMinus(Program&, Changes&){
 }
 
 
+inline void Rule::compilePlan(){
+    _plan.compile(_orderedBody);
+}
+
+
 inline void Rule::initMarks(markEnum mark){
     for (Body::iterator i = _orderedBody.begin(); i != _orderedBody.end(); i++)
         (*i)->setMark(mark);
@@ -0,0 +1,280 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+
+#include "predicate.hpp"
+#include "rule_plan.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+RulePlan::RulePlan() : _pc(0){}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// only positive literals enumerate tuples : the other ones are tests, or bind their free
+// variables by evaluating their input arguments
+void RulePlan::compile(const Literal::Vector& body){
+    _code.resize(body.size());
+    _regs.clear();
+    _pc = 0;
+    for (unsigned int i = 0; i < body.size(); ++i) {
+        Instruction& in = _code[i];
+        Literal* lit = body[i];
+        const variableSet& vars = lit->getFreeVars();
+        in._lit = lit;
+        in._atom = NULL;
+        in._args.clear();
+        in._indexPos = -1;
+        in._stores = getRegisters(vars);
+        if (lit->isPositiveLiteral())
+            in._op = vars.empty() ? PROBE_ : SCAN_;
+        else
+            in._op = vars.empty() ? CHECK_ : ASSIGN_;
+        in._join = -1;
+    }
+    _joins.clear();
+    if (LeapfrogJoin::isEnabled())
+        compileJoins();
+    for (std::vector<Instruction>::iterator it = _code.begin(); it != _code.end(); ++it)
+        if (it->_op == SCAN_)
+            compileScan(*it);
+}
+
+
+// a group begins with a joinable atom, and goes on with joinable atoms and tests (which bind no variable) :
+// the atom that closes a cycle is ground when it is matched (e(X,Y),e(Y,Z),e(Z,X)), so ground atoms
+// whose variables are bound in the group are atoms of the group too
+// when the hypergraph of the variables of its atoms is cyclic (at least three atoms), the group is replaced
+// by a join and then its instructions, in the same order, where the atoms are ground
+// (they are set so : their free variables become previous ones)
+void RulePlan::compileJoins(){
+    std::vector<Instruction> code;
+    variableSet bound;  // variables bound by the previous instructions
+    unsigned int i = 0;
+    while (i < _code.size()) {
+        Literal::Vector atoms;
+        std::vector<variableSet> edges;
+        variableSet joined = bound;     // and by the atoms of the group
+        unsigned int end = i;
+        for (; end < _code.size(); ++end) {
+            Instruction& in = _code[end];
+            variableSet edge;
+            if (((in._op == SCAN_) || (in._op == PROBE_)) && isJoinable(in._lit, joined))
+                for (Argument::iterator t = in._lit->getArgs()->begin(); t != in._lit->getArgs()->end(); ++t)
+                    if ((*t)->isVariable() && (bound.find(static_cast<Variable*>(*t)) == bound.end()))
+                        edge.insert(static_cast<Variable*>(*t));
+            if (!edge.empty()) {
+                joined.insert(edge.begin(), edge.end());
+                edges.push_back(edge);
+                atoms.push_back(in._lit);
+            }
+            else if (atoms.empty() || ((in._op != PROBE_) && (in._op != CHECK_)))
+                break;
+        }
+        if ((atoms.size() < 3) || !LeapfrogJoin::isCyclic(edges)) {
+            const variableSet& vars = _code[i]._lit->getFreeVars();
+            bound.insert(vars.begin(), vars.end());
+            code.push_back(_code[i++]);
+            continue;
+        }
+        Instruction join;
+        join._op = JOIN_;
+        join._lit = NULL;
+        join._atom = NULL;
+        join._indexPos = -1;
+        join._join = _joins.size();
+        _joins.push_back(LeapfrogJoin(atoms, bound));
+        const std::vector<Variable*>& joinVars = _joins.back().getVariables();
+        join._stores = getRegisters(variableSet(joinVars.begin(), joinVars.end()));
+        code.push_back(join);
+        for (; i < end; ++i) {
+            Instruction& in = _code[i];
+            if (in._op == SCAN_) {
+                variableSet previous = in._lit->getPreviousVars();
+                const variableSet& vars = in._lit->getFreeVars();
+                previous.insert(vars.begin(), vars.end());
+                in._lit->setVars(variableSet(), previous);
+                in._op = PROBE_;
+                in._stores.clear();
+            }
+            code.push_back(in);
+        }
+        bound.insert(joinVars.begin(), joinVars.end());
+    }
+    _code.swap(code);
+}
+
+
+// a positive atom whose arguments are constants, variables, or terms whose variables are bound or
+// appear as arguments of the atom : the join binds the variables that appear as arguments
+bool RulePlan::isJoinable(Literal* lit, const variableSet& vs){
+    if (!lit->isPositiveLiteral() || lit->getPred()->isNegatedPredicate())
+        return false;
+    Argument* args = lit->getArgs();
+    for (Argument::iterator t = args->begin(); t != args->end(); ++t)
+        if (!(*t)->isVariable() && !(*t)->isConst()) {
+            variableSet termVars;
+            (*t)->addVariables(termVars);
+            for (variableSet::iterator v = termVars.begin(); v != termVars.end(); ++v)
+                if ((vs.find(*v) == vs.end()) && (std::find(args->begin(), args->end(), *v) == args->end()))
+                    return false;
+        }
+    return true;
+}
+
+
+int RulePlan::getRegister(Variable* v){
+    std::vector<Variable*>::iterator it = std::find(_regs.begin(), _regs.end(), v);
+    if (it != _regs.end())
+        return it - _regs.begin();
+    _regs.push_back(v);
+    return _regs.size() - 1;
+}
+
+
+std::vector<int> RulePlan::getRegisters(const variableSet& vs){
+    std::vector<int> regs;
+    for (variableSet::const_iterator it = vs.begin(); it != vs.end(); ++it)
+        regs.push_back(getRegister(*it));
+    return regs;
+}
+
+
+// a variable is free before the scan if the atom binds it (cf. Literal::getFreeVars), otherwise it has
+// been bound by the previous instructions : terms that are neither constants nor variables are matched
+// by the literal
+void RulePlan::compileScan(Instruction& i){
+    Argument* args = i._lit->getArgs();
+    const variableSet& vars = i._lit->getFreeVars();
+    std::vector<Operand> operands(args->size());
+    std::vector<int> stored;
+    for (unsigned int pos = 0; pos < args->size(); ++pos) {
+        Term* t = (*args)[pos];
+        Operand& a = operands[pos];
+        a._const = NULL;
+        a._reg = -1;
+        if (t->isVariable()) {
+            Variable* v = static_cast<Variable*>(t);
+            a._reg = getRegister(v);
+            if (vars.find(v) == vars.end())
+                a._op = LOAD_;
+            else if (std::find(stored.begin(), stored.end(), a._reg) != stored.end())
+                a._op = SAME_;
+            else {
+                a._op = STORE_;
+                stored.push_back(a._reg);
+            }
+        }
+        else if (t->isNumConst() || t->isSymbConst()) {
+            a._op = CONST_;
+            a._const = t;
+        }
+        else
+            return;
+    }
+    i._atom = static_cast<BasicLiteral*>(i._lit);
+    i._args.swap(operands);
+}
+
+
+// the bound argument chosen by the first match is bound for the next ones
+bool RulePlan::scanTrue(Instruction& i, bool first){
+    const intVector* slots = boundSlots(i, first);
+    Tuple tuple = first ? i._atom->firstTrueTuple(slots) : i._atom->nextTrueTuple(slots);
+    while (!tuple.isNull() && !bind(i, tuple))
+        tuple = i._atom->nextTrueTuple(slots);
+    return !tuple.isNull();
+}
+
+
+// the status of the match is kept by the literal (cf. status)
+statusEnum RulePlan::scanSoft(Instruction& i, bool first, statusEnum previous){
+    const intVector* slots = boundSlots(i, first);
+    std::pair<Tuple, statusEnum> t_s = first ? i._atom->firstSoftTuple(slots) : i._atom->nextSoftTuple(slots);
+    while (t_s.second && !bind(i, t_s.first))
+        t_s = i._atom->nextSoftTuple(slots);
+    statusEnum status = std::min(t_s.second, previous);
+    i._atom->setStatus(status);
+    return status;
+}
+
+
+// as BasicLiteral::boundSlots, but the arguments bound before the scan are known from the compilation
+const intVector* RulePlan::boundSlots(Instruction& i, bool choose){
+    Predicate* pred = i._atom->getPred();
+    if (!choose)
+        return (i._indexPos >= 0) ? &pred->getInstanceIndexes(i._indexPos, getValue(i._args[i._indexPos])) : NULL;
+    const intVector* slots = NULL;
+    i._indexPos = -1;
+    for (unsigned int pos = 0; pos < i._args.size(); ++pos)
+        if ((i._args[pos]._op == CONST_) || (i._args[pos]._op == LOAD_)) {
+            const intVector& s = pred->getInstanceIndexes(pos, getValue(i._args[pos]));
+            if (!slots || (s.size() < slots->size())) {
+                slots = &s;
+                i._indexPos = pos;
+            }
+        }
+    return slots;
+}
+
+
+void RulePlan::release(){
+    for (int i = _pc; i >= 0; --i)
+        free(_code[i]);
+}
+
+
+// a literal that does not match has freed its variables
+bool RulePlan::run(bool matched){
+    for (;;) {
+        if (matched) {
+            if (_pc + 1 == _code.size())
+                return true;
+            matched = firstMatch(_code[++_pc]);
+        }
+        else if (_pc > 0)
+            matched = retry(_code[--_pc]);
+        else
+            return false;
+    }
+}
+
+
+// the status of a match is the minimum of the statuses of the literals matched so far
+statusEnum RulePlan::runSoft(statusEnum status){
+    for (;;) {
+        if (status) {
+            if (_pc + 1 == _code.size())
+                return status;
+            status = firstSoftMatch(_code[++_pc], status);
+        }
+        else if (_pc > 0) {
+            --_pc;
+            status = retrySoft(_code[_pc], previousStatus());
+        }
+        else
+            return NO_;
+    }
+}
@@ -0,0 +1,321 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _RULE_PLAN_HPP_
+#define _RULE_PLAN_HPP_
+
+#include <vector>
+
+#include "basic_literal.hpp"
+#include "definition.hpp"
+#include "leapfrog_join.hpp"
+#include "literal.hpp"
+
+
+
+/**
+ * Execution plan of a body order (cf. Rule::compilePlan) : a flat sequence of instructions,
+ * one for each literal, run by a single back-tracking loop.
+ * An instruction knows from its compilation whether its literal may have several matches
+ * (SCAN_ : atom with free variables) or at most one (PROBE_ : ground atom, CHECK_ : test,
+ * ASSIGN_ : affectation or built-in literal that binds its output variables) : the latter ones
+ * are not asked for a next match when back-tracking.
+ * The variables of the body are numbered at compilation : they form the register file of the plan,
+ * and the instructions refer to registers. A register keeps its binding in its variable
+ * (Variable::_subst), where the terms of the heads and of the other literals read it.
+ * A scanned atom whose arguments are constants and variables is compiled into one operand
+ * for each argument, which compares the tuple with a constant or a bound register, or stores the
+ * tuple in a free register : its tuples are read from the extension and matched by the plan,
+ * without going through the terms and the variable sets of the literal. Other literals match themselves.
+ * The registers bound by an instruction are freed by the plan when back-tracking.
+ * A group of atoms whose variables form a cyclic hypergraph is matched at once by a leapfrog join
+ * (JOIN_ : cf. LeapfrogJoin), the atoms of the group being then ground (PROBE_).
+ */
+class RulePlan{
+
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        typedef enum {SCAN_, PROBE_, CHECK_, ASSIGN_, JOIN_} opEnum;
+
+        /// an argument of a scanned atom is compared to a constant (CONST_) or to a bound register (LOAD_),
+        /// or is stored in a free register (STORE_), or is compared to the register stored by a previous
+        /// argument of the atom (SAME_)
+        typedef enum {CONST_, LOAD_, STORE_, SAME_} operandEnum;
+
+    protected:
+        class Operand{
+            public:
+                operandEnum _op;
+
+                /// register of a LOAD_, STORE_ or SAME_ operand
+                int _reg;
+
+                /// constant of a CONST_ operand
+                Term* _const;
+        };
+
+        class Instruction{
+            public:
+                opEnum _op;
+
+                /// NULL for a join
+                Literal* _lit;
+
+                /// the literal of a compiled scan, NULL otherwise
+                BasicLiteral* _atom;
+
+                /// one operand for each argument of a compiled scan
+                std::vector<Operand> _args;
+
+                /// argument looked up in the extension by the first match of a compiled scan, -1 if none
+                int _indexPos;
+
+                /// registers bound by the instruction
+                std::vector<int> _stores;
+
+                /// number of the join in _joins
+                int _join;
+        };
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        std::vector<Instruction> _code;
+
+        std::vector<LeapfrogJoin> _joins;
+
+        /// register file : the variables of the body
+        std::vector<Variable*> _regs;
+
+        /// current instruction
+        unsigned int _pc;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        RulePlan();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// compile the literals of body, whose free variables are set (cf. Body::initVars)
+        void compile(const Literal::Vector& body);
+
+        inline bool empty() const;
+
+        /// first match of the whole body, false if there is none
+        inline bool first();
+
+        /// next match of the whole body, from the current one
+        inline bool next();
+
+        /// idem with true or mbt matches : return the status of the match of the body (NO_ if there is none)
+        inline statusEnum firstSoft();
+
+        inline statusEnum nextSoft();
+
+        /// the current match is the one of the last instruction (cf. Rule::restorePreviousInstanceNDR)
+        inline void last();
+
+        /// free the variables bound by the current instruction and the previous ones
+        void release();
+
+    protected:
+        /// replace the groups of atoms that have cyclic variables by joins
+        void compileJoins();
+
+        /// true if lit can be matched by a join, knowing that variables of vs are bound
+        static bool isJoinable(Literal* lit, const variableSet& vs);
+
+        /// register of v, added to the register file if needed
+        int getRegister(Variable* v);
+
+        /// registers of the variables of vs
+        std::vector<int> getRegisters(const variableSet& vs);
+
+        /// compile the arguments of the scanned atom of i into operands,
+        /// unless one of them is neither a constant nor a variable
+        void compileScan(Instruction& i);
+
+        /// first match (or next match, from the current one) of the compiled scan i
+        bool scanTrue(Instruction& i, bool first);
+
+        statusEnum scanSoft(Instruction& i, bool first, statusEnum previous);
+
+        /// indexes of the tuples of the extension that agree with the most selective bound argument of
+        /// the compiled scan i (choose), or with the one chosen by its first match ; NULL if none is bound
+        const intVector* boundSlots(Instruction& i, bool choose);
+
+        /// ground term of the operand a, other than a STORE_ operand
+        inline Term* getValue(const Operand& a);
+
+        /// store tuple in the registers of the compiled scan i, if it agrees with its constants and
+        /// bound registers (otherwise the registers of i are freed and false is returned)
+        inline bool bind(Instruction& i, const Tuple& tuple);
+
+        /// free the registers bound by instruction i
+        inline void free(Instruction& i);
+
+        /// from the current instruction, that has just matched or not, until all instructions
+        /// have matched (true) or the first one has no more match (false)
+        bool run(bool matched);
+
+        statusEnum runSoft(statusEnum status);
+
+        /// first match of instruction i
+        inline bool firstMatch(Instruction& i);
+
+        inline statusEnum firstSoftMatch(Instruction& i, statusEnum previous);
+
+        /// free the variables bound by instruction i and try its next match
+        inline bool retry(Instruction& i);
+
+        inline statusEnum retrySoft(Instruction& i, statusEnum previous);
+
+        /// status of the match of the instructions before the current one
+        inline statusEnum previousStatus();
+
+        /// status of the match of instructions 0 to pc
+        inline statusEnum status(int pc);
+
+
+}; // class RulePlan
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline bool RulePlan::empty() const{
+    return _code.empty();
+}
+
+
+// require the plan is not empty
+inline bool RulePlan::first(){
+    _pc = 0;
+    return run(firstMatch(_code[0]));
+}
+
+
+// require the last instruction has matched
+inline bool RulePlan::next(){
+    return run(retry(_code[_pc]));
+}
+
+
+inline statusEnum RulePlan::firstSoft(){
+    _pc = 0;
+    return runSoft(firstSoftMatch(_code[0], TRUE_));
+}
+
+
+inline statusEnum RulePlan::nextSoft(){
+    return runSoft(retrySoft(_code[_pc], previousStatus()));
+}
+
+
+// the iterators of the joins are not those of the last match
+inline void RulePlan::last(){
+    _pc = _code.size() - 1;
+    for (std::vector<LeapfrogJoin>::iterator it = _joins.begin(); it != _joins.end(); ++it)
+        it->resume();
+}
+
+
+inline bool RulePlan::firstMatch(Instruction& i){
+    if (i._op == JOIN_)
+        return _joins[i._join].first();
+    return i._atom ? scanTrue(i, true) : i._lit->firstTrueMatch();
+}
+
+
+// a join matches whatever the status of the tuples : the status is the one of the previous instructions
+inline statusEnum RulePlan::firstSoftMatch(Instruction& i, statusEnum previous){
+    if (i._op == JOIN_)
+        return _joins[i._join].first() ? previous : NO_;
+    else
+        return i._atom ? scanSoft(i, true, previous) : i._lit->firstSoftMatch(previous);
+}
+
+
+// a join frees its own variables
+inline bool RulePlan::retry(Instruction& i){
+    if (i._op == JOIN_)
+        return _joins[i._join].next();
+    free(i);
+    if (i._op != SCAN_)
+        return false;
+    return i._atom ? scanTrue(i, false) : i._lit->nextTrueMatch();
+}
+
+
+inline statusEnum RulePlan::retrySoft(Instruction& i, statusEnum previous){
+    if (i._op == JOIN_)
+        return _joins[i._join].next() ? previous : NO_;
+    free(i);
+    if (i._op != SCAN_)
+        return NO_;
+    return i._atom ? scanSoft(i, false, previous) : i._lit->nextSoftMatch(previous);
+}
+
+
+inline statusEnum RulePlan::previousStatus(){
+    return status(_pc - 1);
+}
+
+
+// the status of a match is kept by the literal (TRUE_ for a test)
+inline statusEnum RulePlan::status(int pc){
+    while ((pc >= 0) && (_code[pc]._op == JOIN_))
+        --pc;
+    return (pc >= 0) ? _code[pc]._lit->getStatus() : TRUE_;
+}
+
+
+inline Term* RulePlan::getValue(const Operand& a){
+    return (a._op == CONST_) ? a._const : _regs[a._reg]->getSubst();
+}
+
+
+// a variable that appears twice in the atom is stored by its first occurrence and compared by the next ones
+inline bool RulePlan::bind(Instruction& i, const Tuple& tuple){
+    for (unsigned int pos = 0; pos < i._args.size(); ++pos) {
+        const Operand& a = i._args[pos];
+        if (a._op == STORE_)
+            _regs[a._reg]->bind(tuple[pos]);
+        else if (getValue(a) != tuple[pos]) {   // ground terms are unique
+            free(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+inline void RulePlan::free(Instruction& i){
+    for (std::vector<int>::iterator it = i._stores.begin(); it != i._stores.end(); ++it)
+        _regs[*it]->free();
+}
+
+
+
+#endif // _RULE_PLAN_HPP_
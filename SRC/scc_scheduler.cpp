@@ -0,0 +1,149 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include "program.hpp"
+#include "scc_scheduler.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+SccScheduler::SccScheduler(Program& p) : _program(p), _context(*Context::current()), _running(0), _failed(-1), _error(NULL){
+    _program.getGraph().getSccDependencies(_dependents, _dependencies);
+    for (unsigned int i = 0; i < _dependencies.size(); ++i)
+        if (_dependencies[i] == 0)
+            _ready.insert(i);
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+SccScheduler::~SccScheduler(){
+    delete _error;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// evaluate all scc with 'jobs' threads (the calling one included)
+// throw the exception of the failed scc of least index, if any (a RuntimeExcept for an exception
+// that is neither a ContradictoryConclusion nor a RuntimeExcept)
+void SccScheduler::run(int jobs){
+    std::vector<pthread_t> threads;
+    for (int i = 1; i < jobs; ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &SccScheduler::work, this) != 0)
+            break;  // less threads, the calling one is enough
+        threads.push_back(thread);
+    }
+    work();
+    for (std::vector<pthread_t>::iterator it = threads.begin(); it != threads.end(); ++it)
+        pthread_join(*it, NULL);
+    if (_failed >= 0) {
+        if (_error)
+            throw *_error;
+        throw ContradictoryConclusion();
+    }
+}
+
+
+// thread function : arg is the scheduler
+void* SccScheduler::work(void* arg){
+    SccScheduler* scheduler = static_cast<SccScheduler*>(arg);
+    Context::Scope scope(scheduler->_context);
+    scheduler->work();
+    return NULL;
+}
+
+
+// evaluate ready scc until there is no more
+void SccScheduler::work(){
+    Graph& graph = _program.getGraph();
+    _mutex.lock();
+    while (true) {
+        while (_ready.empty() && _running > 0)
+            _changed.wait(_mutex);
+        if (_ready.empty())     // nothing is ready nor running : the evaluation is over
+            break;
+        int index = *_ready.begin();
+        _ready.erase(_ready.begin());
+        ++_running;
+        ruleSet recRules;   // recursive rules of the scc
+        ruleSet exitRules;  // exit rules of the scc
+        bool failed = false;
+        try {
+            graph.getRulesFromScc(index, recRules, exitRules, _program);
+            _mutex.unlock();
+            try {
+                _program.evaluateScc(index, recRules, exitRules);
+            }
+            catch (...) {
+                _mutex.lock();
+                throw;
+            }
+            _mutex.lock();
+            graph.setSolvedIfItIsTheCase(index);
+        }
+        catch (const ContradictoryConclusion&) {
+            failed = true;
+            if (_failed < 0 || index < _failed) {
+                delete _error;
+                _error = NULL;
+            }
+        }
+        catch (const RuntimeExcept& e) {
+            failed = true;
+            if (_failed < 0 || index < _failed) {
+                delete _error;
+                _error = new RuntimeExcept(e);
+            }
+        }
+        catch (...) {   // e.g. std::bad_alloc : it must not leave the thread, nor the other threads waiting
+            failed = true;
+            if (_failed < 0 || index < _failed) {
+                delete _error;
+                _error = new RuntimeExcept("evaluation of an scc failed");
+            }
+        }
+        done(index, failed);
+    }
+    _changed.broadcast();
+    _mutex.unlock();
+}
+
+
+// evaluation of scc 'index' is over (failed or not)
+// require _mutex is locked
+void SccScheduler::done(int index, bool failed){
+    --_running;
+    if (failed) {
+        if (_failed < 0 || index < _failed)
+            _failed = index;
+        // scc of greater index are not evaluated (they would not be by a sequential evaluation)
+        _ready.erase(_ready.upper_bound(_failed), _ready.end());
+    }
+    else {
+        for (intVector::iterator it = _dependents[index].begin(); it != _dependents[index].end(); ++it)
+            if (--_dependencies[*it] == 0 && (_failed < 0 || *it < _failed))
+                _ready.insert(*it);
+    }
+    _changed.broadcast();
+}
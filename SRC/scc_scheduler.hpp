@@ -0,0 +1,113 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _SCC_SCHEDULER_HPP_
+#define _SCC_SCHEDULER_HPP_
+
+#include <set>
+#include <vector>
+
+#include "context.hpp"
+#include "definition.hpp"
+#include "exceptions.hpp"
+#include "threads.hpp"
+
+
+class Program;
+
+
+
+/**
+ * SccScheduler evaluates the definite part of a program with a pool of threads.
+ * An scc is ready when all the scc it depends on (cf. Graph::getSccDependencies) are evaluated,
+ * ready scc are evaluated at the same time, lowest index first.
+ * Rules of an scc are collected and its solved status is computed while holding the scheduler's mutex,
+ * since they modify the program and the graph ; only the evaluation of its rules is done concurrently.
+ * If the evaluation of some scc fails, scc of greater indexes are not started and the failure of
+ * least index is thrown again by run(), so that the result is the one of the sequential evaluation.
+ */
+class SccScheduler{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        Program& _program;
+
+        /// context of the calling thread, to which the threads of the pool are bound
+        Context& _context;
+
+        /// for each scc, scc that depend on it
+        std::vector<intVector> _dependents;
+
+        /// for each scc, number of scc it depends on that are not yet evaluated
+        intVector _dependencies;
+
+        /// scc ready to be evaluated
+        std::set<int> _ready;
+
+        /// number of scc being evaluated
+        int _running;
+
+        /// least index of scc whose evaluation failed, -1 if none
+        int _failed;
+
+        /// exception thrown by the evaluation of scc _failed (NULL for ContradictoryConclusion)
+        RuntimeExcept* _error;
+
+        Mutex _mutex;
+
+        /// signaled when an scc becomes ready or when the evaluation is over
+        Condition _changed;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        SccScheduler(Program& p);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        virtual ~SccScheduler();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// evaluate all scc with 'jobs' threads (the calling one included)
+        /// throw the exception of the failed scc of least index, if any
+        void run(int jobs);
+
+    protected:
+        /// thread function : arg is the scheduler
+        static void* work(void* arg);
+
+        /// evaluate ready scc until there is no more
+        void work();
+
+        /// evaluation of scc 'index' is over (failed or not)
+        void done(int index, bool failed);
+
+
+}; // class SccScheduler
+
+
+
+#endif // _SCC_SCHEDULER_HPP_
@@ -0,0 +1,131 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <climits>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "search_control.hpp"
+
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+// the sequence is made of blocks 1 1 2 ... 2^(k-1) : the i-th element ends a block
+// of size 2^k-1 if i = 2^k-1, otherwise it is the (i-2^(k-1)+1)-th element of the sequence
+int SearchControl::luby(int i){
+    int k = 1;
+    while ((k < 30) && (((1 << k) - 1) < i))
+        k++;
+    while ((k < 30) && (i != (1 << k) - 1)) {
+        i -= (1 << (k - 1)) - 1;
+        k = 1;
+        while (((1 << k) - 1) < i)
+            k++;
+    }
+    return 1 << (k - 1);
+}
+
+
+double SearchControl::now(){
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+// ru_maxrss is given in kilobytes
+long SearchControl::memory(){
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return usage.ru_maxrss / 1024;
+}
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+SearchControl::SearchControl()
+ : _time_limit(0), _choice_limit(0), _memory_limit(0), _progress(0), _restart_policy(NO_RESTART), _restart_base(100),
+   _checking(false), _start(0), _elapsed(0), _last_progress(0), _restarts(0), _restart_bad_choice(0), _restart_interval(0),
+   _interruption(NULL){}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+bool SearchControl::setRestartPolicy(const std::string& name){
+    if (name == "none")
+        _restart_policy = NO_RESTART;
+    else if (name == "luby")
+        _restart_policy = LUBY_RESTART;
+    else if (name == "geometric")
+        _restart_policy = GEOMETRIC_RESTART;
+    else
+        return false;
+    return true;
+}
+
+
+void SearchControl::start(){
+    _start = now();
+    _elapsed = 0;
+    _last_progress = 0;
+    _restarts = 0;
+    _restart_bad_choice = 0;
+    _restart_interval = _restart_base;
+    _interruption = NULL;
+}
+
+
+// the clock is read only if a time limit or progress lines are asked for
+bool SearchControl::checkLimits(int choicePoints){
+    if ((_time_limit > 0) || (_progress > 0))
+        _elapsed = now() - _start;
+    if ((_time_limit > 0) && (_elapsed >= _time_limit))
+        _interruption = "time limit";
+    else if ((_choice_limit > 0) && (choicePoints >= _choice_limit))
+        _interruption = "choice point limit";
+    else if ((_memory_limit > 0) && (memory() >= _memory_limit))
+        _interruption = "memory limit";
+    return _interruption != NULL;
+}
+
+
+bool SearchControl::progressDue(){
+    if ((_progress <= 0) || (_elapsed - _last_progress < _progress))
+        return false;
+    _last_progress = _elapsed;
+    return true;
+}
+
+
+// the interval grows with the number of restarts, so that the search remains complete
+void SearchControl::restarted(int badChoice){
+    _restarts++;
+    _restart_bad_choice = badChoice;
+    double interval = _restart_base;
+    if (_restart_policy == LUBY_RESTART)
+        interval *= luby(_restarts + 1);
+    else
+        for (int i = 0; (i < _restarts) && (interval < INT_MAX); ++i)
+            interval *= 1.5;
+    _restart_interval = (interval < INT_MAX) ? (int) interval : INT_MAX;
+}
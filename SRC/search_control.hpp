@@ -0,0 +1,224 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _SEARCH_CONTROL_HPP_
+#define _SEARCH_CONTROL_HPP_
+
+#include <string>
+
+
+
+/**
+ * Limits, restarts and progress reporting of an answer set search (cf. Program::answerSetSearch).
+ * The search is interrupted when it exceeds a wall-clock time, a number of choice points
+ * or a memory size (peak resident set size of the process).
+ * A restart policy gives the number of bad choices after which the search goes back to its first
+ * choice point, keeping what it has learned (nogoods, activities of the heuristic) : a geometric
+ * policy multiplies this number by 1.5 after each restart, a Luby policy follows the sequence
+ * 1 1 2 1 1 2 4 1 1 2... times the base.
+ */
+class SearchControl{
+
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        enum restartEnum {NO_RESTART, LUBY_RESTART, GEOMETRIC_RESTART};
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// limits, 0 for none : seconds, choice points and megabytes
+        double _time_limit;
+
+        int _choice_limit;
+
+        int _memory_limit;
+
+        /// seconds between two progress lines, 0 for none
+        double _progress;
+
+        restartEnum _restart_policy;
+
+        /// number of bad choices before the first restart
+        int _restart_base;
+
+        /// true if some limit or progress line has to be checked
+        bool _checking;
+
+        /// start of the search, and elapsed seconds at the last check
+        double _start;
+
+        double _elapsed;
+
+        /// elapsed seconds at the last progress line
+        double _last_progress;
+
+        /// number of restarts, and bad choices at the last one
+        int _restarts;
+
+        int _restart_bad_choice;
+
+        /// number of bad choices between the last restart and the next one
+        int _restart_interval;
+
+        /// exceeded limit, NULL if the search is not interrupted
+        const char* _interruption;
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+    public:
+        /// wall-clock time, in seconds
+        static double now();
+
+    protected:
+        /// i-th element of the Luby sequence (from 1)
+        static int luby(int i);
+
+        /// peak resident set size of the process, in megabytes
+        static long memory();
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        SearchControl();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        inline void setTimeLimit(double seconds);
+
+        inline void setChoiceLimit(int n);
+
+        inline void setMemoryLimit(int megabytes);
+
+        inline void setProgress(double seconds);
+
+        /// policy of the given name (none, luby or geometric), return false if there is none
+        bool setRestartPolicy(const std::string& name);
+
+        inline void setRestartBase(int n);
+
+        inline bool isRestarting() const;
+
+        /// true if some limit or progress line has to be checked
+        inline bool isChecking() const;
+
+        inline int getRestarts() const;
+
+        /// seconds since the start of the search, at the last check
+        inline double getElapsed() const;
+
+        /// exceeded limit ("time limit"...), NULL if the search has not been interrupted
+        inline const char* getInterruption() const;
+
+        /// the search starts : time is measured from now
+        void start();
+
+        /// true if the search has to be interrupted after choicePoints choice points
+        inline bool limitReached(int choicePoints);
+
+        /// true if a progress line has to be printed (once per period, after limitReached)
+        bool progressDue();
+
+        /// true if the search has to restart after badChoice bad choices
+        inline bool restartDue(int badChoice) const;
+
+        /// the search restarts after badChoice bad choices
+        void restarted(int badChoice);
+
+    protected:
+        bool checkLimits(int choicePoints);
+
+
+}; // class SearchControl
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline void SearchControl::setTimeLimit(double seconds){
+    _time_limit = seconds;
+    _checking = true;
+}
+
+
+inline void SearchControl::setChoiceLimit(int n){
+    _choice_limit = n;
+    _checking = true;
+}
+
+
+inline void SearchControl::setMemoryLimit(int megabytes){
+    _memory_limit = megabytes;
+    _checking = true;
+}
+
+
+inline void SearchControl::setProgress(double seconds){
+    _progress = seconds;
+    _checking = true;
+}
+
+
+inline void SearchControl::setRestartBase(int n){
+    _restart_base = n;
+}
+
+
+inline bool SearchControl::isRestarting() const{
+    return _restart_policy != NO_RESTART;
+}
+
+
+inline bool SearchControl::isChecking() const{
+    return _checking;
+}
+
+
+inline int SearchControl::getRestarts() const{
+    return _restarts;
+}
+
+
+inline double SearchControl::getElapsed() const{
+    return _elapsed;
+}
+
+
+inline const char* SearchControl::getInterruption() const{
+    return _interruption;
+}
+
+
+inline bool SearchControl::limitReached(int choicePoints){
+    return _checking && checkLimits(choicePoints);
+}
+
+
+inline bool SearchControl::restartDue(int badChoice) const{
+    return (_restart_policy != NO_RESTART) && (badChoice - _restart_bad_choice >= _restart_interval);
+}
+
+
+
+#endif // _SEARCH_CONTROL_HPP_
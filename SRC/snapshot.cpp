@@ -0,0 +1,365 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "func_term.hpp"
+#include "list.hpp"
+#include "num_const.hpp"
+#include "predicate.hpp"
+#include "program.hpp"
+#include "snapshot.hpp"
+#include "symb_const.hpp"
+
+
+
+// first bytes of a snapshot file, followed by 0x01020304 in the byte order of the machine
+static const char magic[8] = {'A', 'S', 'P', 'X', 'S', 'N', 'P', '1'};
+
+// kinds of the saved terms
+enum {NUM_TERM, SYMB_TERM, FUNC_TERM, LIST_TERM, EMPTY_LIST_TERM};
+
+
+static void putInt(std::string& s, uint32_t n){
+    s.append(reinterpret_cast<const char*>(&n), sizeof(n));
+}
+
+
+static void putString(std::string& s, const std::string& str){
+    putInt(s, str.size());
+    s.append(str);
+}
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+Snapshot::Snapshot() : _fingerprint(0), _facts(), _data(NULL), _size(0), _terms(), _extensions(){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+Snapshot::~Snapshot(){
+    if (_data)
+        munmap(const_cast<char*>(_data), _size);
+}
+
+
+//********************************** GETTERS *********************************//
+
+int Snapshot::getRestored() const{
+    int n = 0;
+    for (std::map<Predicate*, Extension>::const_iterator it = _extensions.begin(); it != _extensions.end(); ++it)
+        if (it->second.restored)
+            ++n;
+    return n;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+void Snapshot::record(Program& p){
+    _fingerprint = p.fingerprint();
+    _facts.clear();
+    const mapPredicate& preds = Predicate::getPredicates();
+    for (mapPredicate::const_iterator it = preds.begin(); it != preds.end(); ++it)
+        _facts[it->second] = it->second->getEndIndex() + 1;
+}
+
+
+// terms and tuples are written in the byte order of the machine
+void Snapshot::save(const std::string& fileName){
+    std::map<Term*, unsigned int> ids;
+    std::string terms;
+    std::string extensions;
+    const mapPredicate& preds = Predicate::getPredicates();
+    for (mapPredicate::const_iterator it = preds.begin(); it != preds.end(); ++it) {
+        Predicate* p = it->second;
+        std::map<Predicate*, int>::const_iterator facts = _facts.find(p);
+        int size = p->getEndIndex() + 1;
+        putString(extensions, it->first);
+        putInt(extensions, p->getArity());
+        putInt(extensions, (facts != _facts.end()) ? facts->second : 0);
+        putInt(extensions, size);
+        for (int i = 0; i < size; ++i) {
+            extensions.push_back(static_cast<char>(p->getOrderedStatus(i)));
+            Tuple tuple = p->getOrderedInstance(i);
+            for (Tuple::const_iterator t = tuple.begin(); t != tuple.end(); ++t)
+                putInt(extensions, number(*t, ids, terms));
+        }
+    }
+
+    std::string header(magic, sizeof(magic));
+    putInt(header, 0x01020304);
+    header.append(reinterpret_cast<const char*>(&_fingerprint), sizeof(_fingerprint));
+    putInt(header, ids.size());
+    std::string count;
+    putInt(count, preds.size());
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file << header << terms << count << extensions;
+    file.close();
+    if (!file)
+        throw RuntimeExcept("can not write `" + fileName + "`");
+}
+
+
+bool Snapshot::load(const std::string& fileName, Program& p){
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw RuntimeExcept("can not open `" + fileName + "`");
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        throw RuntimeExcept("`" + fileName + "` is not a snapshot");
+    }
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        throw RuntimeExcept("can not map `" + fileName + "` in memory");
+    _data = static_cast<const char*>(data);
+    _size = st.st_size;
+
+    size_t pos = 0;
+    char head[sizeof(magic)];
+    read(pos, head, sizeof(magic));
+    if (memcmp(head, magic, sizeof(magic)) != 0)
+        throw RuntimeExcept("`" + fileName + "` is not a snapshot");
+    if (readInt(pos) != 0x01020304)
+        throw RuntimeExcept("`" + fileName + "` was saved on a machine of another byte order");
+    uint64_t fingerprint;
+    read(pos, &fingerprint, sizeof(fingerprint));
+    if (fingerprint != p.fingerprint())
+        return false;
+
+    // ground terms
+    uint32_t n = readInt(pos);
+    _terms.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        char kind;
+        read(pos, &kind, 1);
+        switch (kind) {
+            case NUM_TERM:
+                _terms.push_back(NumConst::new_NumConst(static_cast<int32_t>(readInt(pos))));
+                break;
+            case SYMB_TERM:
+                _terms.push_back(SymbConst::new_SymbConst(readString(pos)));
+                break;
+            case FUNC_TERM: {
+                std::string name = readString(pos);
+                uint32_t arity = readInt(pos);
+                Argument* args = new Argument();
+                try {
+                    for (uint32_t a = 0; a < arity; ++a)
+                        args->push_back(readTerm(pos));
+                }
+                catch (const RuntimeExcept&) {
+                    delete args;
+                    throw;
+                }
+                _terms.push_back(FuncTerm::new_FuncTerm(name, args));
+                break;
+            }
+            case LIST_TERM: {
+                Term* head = readTerm(pos);
+                _terms.push_back(List::new_List(head, readTerm(pos)));
+                break;
+            }
+            case EMPTY_LIST_TERM:
+                _terms.push_back(List::getEmptyList());
+                break;
+            default:
+                throw RuntimeExcept("`" + fileName + "` is corrupted");
+        }
+    }
+
+    // extensions : a predicate is clean if its facts are the saved facts (in the same order)
+    const mapPredicate& preds = Predicate::getPredicates();
+    n = readInt(pos);
+    Argument tuple;
+    for (uint32_t i = 0; i < n; ++i) {
+        std::string name = readString(pos);
+        Extension e;
+        int arity = readInt(pos);
+        e.facts = readInt(pos);
+        e.size = readInt(pos);
+        e.offset = pos;
+        e.restored = false;
+        size_t record = 1 + arity * sizeof(uint32_t);
+        if ((e.facts > e.size) || ((_size - pos) / record < (size_t) e.size))
+            throw RuntimeExcept("`" + fileName + "` is corrupted");
+        pos += e.size * record;
+
+        mapPredicate::const_iterator it = preds.find(name);
+        if (it == preds.end())  // the predicate only appeared in the facts of the saved run
+            continue;
+        Predicate* pred = it->second;
+        e.clean = (pred->getArity() == arity) && (pred->getEndIndex() + 1 == e.facts);
+        size_t at = e.offset;
+        for (int f = 0; e.clean && (f < e.facts); ++f) {
+            statusEnum status = readTuple(at, arity, tuple);
+            e.clean = (status == pred->getOrderedStatus(f)) && (pred->getOrderedInstance(f) == tuple);
+        }
+        _extensions[pred] = e;
+    }
+    return true;
+}
+
+
+// the sccs are evaluated after the sccs they depend on (cf. Node::addSccDependencies) :
+// if they have been restored, the extensions of scc index are those of the saved run
+bool Snapshot::restoreScc(Graph& g, int index){
+    if (!_data)
+        return false;
+    Node::Set scc;
+    g.getNodesFromScc(index, scc);
+    for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i) {
+        Predicate* p = (*i)->getPred();
+        if (p == Predicate::getTruePredicate())
+            continue;
+        std::map<Predicate*, Extension>::const_iterator it = _extensions.find(p);
+        if ((it == _extensions.end()) || !it->second.clean)
+            return false;
+        if (p->hasOppositePredicate() && !isRestored(p->getOppositePredicate()->getNode()) && (p->getOppositePredicate()->getNode()->getSccIndex() != index))
+            return false;
+        Node::Vector* succ[2] = {&(*i)->getPosSucc(), &(*i)->getNegSucc()};
+        for (int k = 0; k < 2; ++k)
+            for (Node::Vector::iterator s = succ[k]->begin(); s != succ[k]->end(); ++s) {
+                if (((*s)->getSccIndex() != index) && !isRestored(*s))
+                    return false;
+                Predicate* q = (*s)->getPred();
+                if (q->hasOppositePredicate() && (q->getOppositePredicate()->getNode()->getSccIndex() != index) && !isRestored(q->getOppositePredicate()->getNode()))
+                    return false;
+            }
+    }
+
+    Argument tuple;
+    for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i) {
+        Predicate* p = (*i)->getPred();
+        if (p == Predicate::getTruePredicate())
+            continue;
+        Extension& e = _extensions.find(p)->second;
+        size_t pos = e.offset + e.facts * (1 + p->getArity() * sizeof(uint32_t));
+        for (int t = e.facts; t < e.size; ++t) {
+            if (readTuple(pos, p->getArity(), tuple) == MBT_)
+                p->addMbtInstance(tuple);
+            else    // TRUE_, or TRUE_MBT_ for the update of an MBT_ tuple
+                p->addTrueInstance(tuple);
+        }
+    }
+    g.initDelta(index);
+    g.setDelta(index);      // empty deltas, as at the end of a fixpoint
+    for (Node::Set::iterator i = scc.begin(); i != scc.end(); ++i)
+        if ((*i)->getPred() != Predicate::getTruePredicate())
+            _extensions.find((*i)->getPred())->second.restored = true;
+    return true;
+}
+
+
+bool Snapshot::isRestored(Node* n){
+    if (n->getPred() == Predicate::getTruePredicate())
+        return true;
+    std::map<Predicate*, Extension>::const_iterator it = _extensions.find(n->getPred());
+    return (it != _extensions.end()) && it->second.restored;
+}
+
+
+unsigned int Snapshot::number(Term* t, std::map<Term*, unsigned int>& ids, std::string& terms){
+    std::map<Term*, unsigned int>::iterator it = ids.find(t);
+    if (it != ids.end())
+        return it->second;
+
+    std::string record;
+    if (t == List::getEmptyList())
+        record.push_back(EMPTY_LIST_TERM);
+    else if (t->isNumConst()) {
+        record.push_back(NUM_TERM);
+        putInt(record, static_cast<uint32_t>(t->getIntValue()));
+    }
+    else if (t->isSymbConst()) {
+        record.push_back(SYMB_TERM);
+        putString(record, t->getStringValue());
+    }
+    else if (t->isList()) {
+        record.push_back(LIST_TERM);
+        putInt(record, number((*t->getArgs())[0], ids, terms));
+        putInt(record, number((*t->getArgs())[1], ids, terms));
+    }
+    else if (t->isFuncTerm()) {
+        record.push_back(FUNC_TERM);
+        putString(record, t->getFunctor()->getStringValue());
+        putInt(record, t->getArgs()->size());
+        for (Argument::iterator a = t->getArgs()->begin(); a != t->getArgs()->end(); ++a)
+            putInt(record, number(*a, ids, terms));
+    }
+    else
+        throw RuntimeExcept("the term can not be saved in a snapshot");
+    terms.append(record);   // after the records of the arguments
+    unsigned int id = ids.size();
+    ids[t] = id;
+    return id;
+}
+
+
+void Snapshot::read(size_t& pos, void* buffer, size_t n) const{
+    if (_size - pos < n)
+        throw RuntimeExcept("snapshot is corrupted");
+    memcpy(buffer, _data + pos, n);
+    pos += n;
+}
+
+
+uint32_t Snapshot::readInt(size_t& pos) const{
+    uint32_t n;
+    read(pos, &n, sizeof(n));
+    return n;
+}
+
+
+std::string Snapshot::readString(size_t& pos) const{
+    uint32_t n = readInt(pos);
+    if (_size - pos < n)
+        throw RuntimeExcept("snapshot is corrupted");
+    pos += n;
+    return std::string(_data + pos - n, n);
+}
+
+
+Term* Snapshot::readTerm(size_t& pos) const{
+    uint32_t id = readInt(pos);
+    if (id >= _terms.size())
+        throw RuntimeExcept("snapshot is corrupted");
+    return _terms[id];
+}
+
+
+statusEnum Snapshot::readTuple(size_t& pos, int arity, Argument& tuple) const{
+    char status;
+    read(pos, &status, 1);
+    tuple.clear();
+    for (int a = 0; a < arity; ++a)
+        tuple.push_back(readTerm(pos));
+    return static_cast<statusEnum>(status);
+}
@@ -0,0 +1,150 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _SNAPSHOT_HPP_
+#define _SNAPSHOT_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "arguments.hpp"
+#include "definition.hpp"
+#include "exceptions.hpp"
+#include "graph.hpp"
+#include "term.hpp"
+
+class Predicate;
+class Program;
+
+
+
+/**
+ * A Snapshot is the state of the predicate extensions after the evaluation of the definite part of a
+ * program (cf. Program::evaluate), saved in a binary file (option -save) so that a later run of the
+ * same rules can restore it instead of evaluating them again (option -load).
+ *
+ * The file holds a fingerprint of the rules, the ground terms of the extensions (each one after its
+ * arguments) and, for each predicate, its ordered extension with the status of each tuple and the
+ * number of tuples that were facts.
+ * The rules are not saved : they are read from the program, which is checked against the fingerprint.
+ *
+ * The facts may change from one run to another : the extensions of an scc are restored from the
+ * mapped file only if the facts of its predicates are the facts of the saved run and if the sccs it
+ * depends on are restored. Other sccs are evaluated (cf. Program::evaluateScc).
+ */
+class Snapshot{
+
+//******************************* NESTED TYPES *******************************//
+
+    protected:
+        /// a predicate of the loaded file
+        struct Extension{
+            /// number of facts, and of tuples after the evaluation
+            int facts;
+            int size;
+
+            /// offset of the first tuple in the file
+            size_t offset;
+
+            /// the facts of this run are the saved facts
+            bool clean;
+
+            /// the extension has been restored
+            bool restored;
+        };
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+        /// fingerprint of the rules and number of facts of each predicate before the evaluation (cf. record)
+        uint64_t _fingerprint;
+        std::map<Predicate*, int> _facts;
+
+        /// loaded file, mapped in memory
+        const char* _data;
+        size_t _size;
+
+        /// ground terms of the loaded file, by number
+        Term::Vector _terms;
+
+        std::map<Predicate*, Extension> _extensions;
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        Snapshot();
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        ~Snapshot();
+
+
+//********************************** GETTERS *********************************//
+
+        /// number of predicates whose extension has been restored
+        int getRestored() const;
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// record the fingerprint of p and its facts, before its evaluation
+        void record(Program& p);
+
+        /// save the extensions of the predicates in file fileName, after the evaluation of the program recorded
+        void save(const std::string& fileName);
+
+        /// load file fileName for the evaluation of p, return false if it was saved from other rules
+        /// (throw RuntimeExcept if the file can not be read)
+        bool load(const std::string& fileName, Program& p);
+
+        /// restore the extensions of scc index if it is possible, instead of evaluating it
+        bool restoreScc(Graph& g, int index);
+
+    protected:
+        /// true if the predicate of node n is restored (or needs no restoring)
+        bool isRestored(Node* n);
+
+        /// number of t in ids, after the numbers of its arguments : t is added to terms if it is new
+        unsigned int number(Term* t, std::map<Term*, unsigned int>& ids, std::string& terms);
+
+        /// read n bytes at offset pos of the loaded file, and move pos after them
+        void read(size_t& pos, void* buffer, size_t n) const;
+
+        /// read an unsigned integer, a string or the number of a term at offset pos of the loaded file
+        uint32_t readInt(size_t& pos) const;
+        std::string readString(size_t& pos) const;
+        Term* readTerm(size_t& pos) const;
+
+        /// read a tuple of arity terms at offset pos of the loaded file, and return its status
+        statusEnum readTuple(size_t& pos, int arity, Argument& tuple) const;
+
+
+}; // class Snapshot
+
+
+
+
+#endif // _SNAPSHOT_HPP_
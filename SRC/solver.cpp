@@ -0,0 +1,174 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+#include <cstdio>
+
+#include "built_in_literal.hpp"
+#include "fact_loader.hpp"
+#include "program.hpp"
+#include "solver.hpp"
+
+
+extern Program* readProg(const char*,int,const std::vector<std::string>&);
+extern Program* readProg(FILE*,int);
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+Solver::Solver() : _context(), _program(NULL), _facts(NULL), _contradictory(false), _solved(false){}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+Solver::~Solver(){
+    Context::Scope scope(_context);
+    clear();
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// the functions of the solver work in its context (and the handler of the answer sets as well)
+// a contradiction between the facts of the program leaves no program : it has no answer set
+void Solver::loadFile(const std::string& fileName){
+    Context::Scope scope(_context);
+    clear();
+    try {
+        _program = readProg(fileName.c_str(), 0, std::vector<std::string>());
+    }
+    catch (const ContradictoryConclusion&) {
+        _contradictory = true;
+        return;
+    }
+    if (!_program)
+        throw RuntimeExcept("errors in `" + fileName + "`");
+    _facts = new FactLoader(_program->getGraph());
+}
+
+
+void Solver::loadString(const std::string& text){
+    Context::Scope scope(_context);
+    clear();
+    std::string buffer = text + '\n';   // never empty
+    FILE* in = fmemopen(&buffer[0], buffer.size(), "r");
+    if (!in)
+        throw RuntimeExcept("can not read the program");
+    try {
+        _program = readProg(in, 0);
+    }
+    catch (const ContradictoryConclusion&) {
+        _contradictory = true;
+    }
+    fclose(in);
+    if (_contradictory)
+        return;
+    if (!_program)
+        throw RuntimeExcept("errors in the program");
+    _facts = new FactLoader(_program->getGraph());
+}
+
+
+void Solver::addFact(const std::string& fact){
+    Context::Scope scope(_context);
+    checkLoaded();
+    try {
+        if (!_contradictory)
+            _facts->add(fact);
+    }
+    catch (const ContradictoryConclusion&) {
+        _contradictory = true;
+    }
+}
+
+
+void Solver::addFact(const std::string& name, const std::vector<std::string>& fields){
+    Context::Scope scope(_context);
+    checkLoaded();
+    try {
+        if (!_contradictory)
+            _facts->add(name, fields);
+    }
+    catch (const ContradictoryConclusion&) {
+        _contradictory = true;
+    }
+}
+
+
+int Solver::addFacts(const std::string& fileName){
+    Context::Scope scope(_context);
+    checkLoaded();
+    try {
+        if (!_contradictory)
+            return _facts->load(fileName);
+    }
+    catch (const ContradictoryConclusion&) {
+        _contradictory = true;
+    }
+    return 0;
+}
+
+
+// as the main function of asperix
+int Solver::solve(AnswerSetHandler& handler, int n){
+    Context::Scope scope(_context);
+    checkLoaded();
+    _solved = true;
+    if (_contradictory)
+        return 0;
+    _program->setSearchJobs(1);     // worker processes would give the answer sets as text
+    _program->setAnswerSetHandler(&handler);
+    int found = 0;
+    try {
+        _program->evaluate();
+        if (!_program->isDefinite())
+            found = _program->answerSetSearch(n);
+        else if (!_program->existsSupportedNonBlockedProhibitedRule()) {
+            _program->setAnswerNumber(1);
+            handler.answerSet(AnswerSet(1));
+            found = 1;
+        }
+    }
+    catch (const ContradictoryConclusion&) {
+        found = 0;
+    }
+    _program->setAnswerSetHandler(NULL);
+    return found;
+}
+
+
+void Solver::clear(){
+    delete _facts;
+    _facts = NULL;
+    if (_program) {
+        delete _program;
+        _program = NULL;
+        BuiltInLiteral::closeDynamicLibraries();
+    }
+    _contradictory = false;
+    _solved = false;
+}
+
+
+void Solver::checkLoaded() const{
+    if (!_program && !_contradictory)
+        throw LogicExcept("no program has been read");
+    if (_solved)
+        throw LogicExcept("the program has already been solved");
+}
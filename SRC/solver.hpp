@@ -0,0 +1,138 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+#ifndef _SOLVER_HPP_
+#define _SOLVER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "answer_set.hpp"
+#include "context.hpp"
+#include "exceptions.hpp"
+
+class FactLoader;
+class Program;
+
+
+
+/**
+ * A Solver is the entry point of the library libasperix (cf. Makefile), for a program which embeds
+ * the solver instead of running asperix and parsing its output :
+ *  - the program is read from a file or from a string (loadFile, loadString),
+ *  - ground facts may be added to it (addFact, addFacts),
+ *  - its answer sets are given to an AnswerSetHandler (solve).
+ *
+ * Each solver has its own predicates and terms (getContext) : solvers of different threads read and solve
+ * their programs at the same time. A solver is used by one thread at a time.
+ * The options of the command line are set on the program (getProgram) or, for the limits of the
+ * terms (NumConst::setMaxInt, FuncTerm::setMaxDepth) and the compilation of the rules
+ * (Body::setCostBasedOrder, LeapfrogJoin::setEnabled), before the program is read, in the context of
+ * the solver :
+ *      Context::Scope scope(solver.getContext());
+ *      NumConst::setMaxInt(100000);
+ * The dynamic libraries of the #include directives use the symbols of the solver : a program linked
+ * with libasperix.a must export them (-rdynamic), as asperix does.
+ */
+class Solver{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// predicates and terms of the program, limits of the terms, options of the rules
+        Context _context;
+
+        Program* _program;
+
+        /// facts added to the program
+        FactLoader* _facts;
+
+        /// the facts contradict each other : there is no answer set
+        bool _contradictory;
+
+        /// the program has been solved
+        bool _solved;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        Solver();
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        ~Solver();
+
+
+//********************************** GETTERS *********************************//
+
+        inline Context& getContext();
+
+        /// program read, NULL before loadFile or loadString
+        inline Program* getProgram();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// read the program of file fileName, or whose text is text, in place of the program already read
+        /// (throw RuntimeExcept if it has errors : they are printed on the standard error output)
+        void loadFile(const std::string& fileName);
+        void loadString(const std::string& text);
+
+        /// add a fact to the program, written as a line of a facts file : "p(a,1)." or "p<TAB>a<TAB>1"
+        /// (cf. FactLoader) ; throw RuntimeExcept if it is malformed
+        void addFact(const std::string& fact);
+
+        /// add fact name(fields) to the program, a field which is not a constant being a string
+        void addFact(const std::string& name, const std::vector<std::string>& fields);
+
+        /// add the facts of file fileName to the program, and return their number
+        int addFacts(const std::string& fileName);
+
+        /// search for n answer sets of the program (0 for all) and give them to handler, until it
+        /// returns false ; return the number of answer sets found
+        /// a program is solved once : throw LogicExcept if it has already been solved
+        int solve(AnswerSetHandler& handler, int n = 0);
+
+    protected:
+        /// delete the program read
+        void clear();
+
+        /// the program is read and not solved (throw LogicExcept otherwise)
+        void checkLoaded() const;
+
+
+}; // class Solver
+
+
+//********************************** GETTERS *********************************//
+
+inline Context& Solver::getContext(){
+    return _context;
+}
+
+
+inline Program* Solver::getProgram(){
+    return _program;
+}
+
+
+
+#endif // _SOLVER_HPP_
@@ -0,0 +1,133 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#include <algorithm>
+#include <utility>
+
+#include "context.hpp"
+#include "predicate.hpp"
+#include "sorted_index.hpp"
+
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+Mutex& SortedIndex::mutex(){
+    return Context::current()->_indexMutex;
+}
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+SortedIndex::SortedIndex() : _columns(), _keys(), _rows(), _size(0), _valid(0), _version(0){}
+
+
+SortedIndex::SortedIndex(const intVector& columns) : _columns(columns), _keys(), _rows(), _size(0), _valid(0), _version(0){}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+void SortedIndex::build(Predicate* p, int begin, int end){
+    _keys.clear();
+    _rows.clear();
+    add(p, begin, end);
+    _size = _valid = end + 1;
+    ++_version;
+}
+
+
+// only the tuples added or removed since the last update are sorted
+void SortedIndex::update(Predicate* p){
+    if (_valid < _size) {
+        drop();
+        _size = _valid;
+        ++_version;
+    }
+    int end = p->getEndIndex();
+    if (end >= _size) {
+        add(p, _size, end);
+        _size = _valid = end + 1;
+        ++_version;
+    }
+}
+
+
+void SortedIndex::add(Predicate* p, int begin, int end){
+    if (end < begin)
+        return;
+    unsigned int width = _columns.size();
+    std::vector< std::pair<Term::Vector, int> > tuples(end - begin + 1);
+    for (int i = begin; i <= end; ++i) {
+        Tuple tv = p->getOrderedInstance(i);
+        Term::Vector& key = tuples[i - begin].first;
+        key.resize(width);
+        for (unsigned int c = 0; c < width; ++c)
+            key[c] = tv[_columns[c]];
+        tuples[i - begin].second = i;
+    }
+    std::sort(tuples.begin(), tuples.end());
+    Term::Vector keys;
+    intVector rows;
+    keys.reserve(tuples.size() * width);
+    rows.reserve(tuples.size());
+    for (unsigned int t = 0; t < tuples.size(); ++t) {
+        keys.insert(keys.end(), tuples[t].first.begin(), tuples[t].first.end());
+        rows.push_back(tuples[t].second);
+    }
+    if (_rows.empty()) {
+        _keys.swap(keys);
+        _rows.swap(rows);
+        return;
+    }
+    // merge the new rows with the previous ones
+    Term::Vector mergedKeys;
+    intVector mergedRows;
+    mergedKeys.reserve(_keys.size() + keys.size());
+    mergedRows.reserve(_rows.size() + rows.size());
+    unsigned int a = 0;
+    unsigned int b = 0;
+    while ((a < _rows.size()) || (b < rows.size())) {
+        if ((b == rows.size()) || ((a < _rows.size()) && !lower(keys, b, _keys, a))) {
+            mergedKeys.insert(mergedKeys.end(), _keys.begin() + a * width, _keys.begin() + (a + 1) * width);
+            mergedRows.push_back(_rows[a++]);
+        }
+        else {
+            mergedKeys.insert(mergedKeys.end(), keys.begin() + b * width, keys.begin() + (b + 1) * width);
+            mergedRows.push_back(rows[b++]);
+        }
+    }
+    _keys.swap(mergedKeys);
+    _rows.swap(mergedRows);
+}
+
+
+// the order of the remaining rows is kept
+void SortedIndex::drop(){
+    unsigned int width = _columns.size();
+    unsigned int kept = 0;
+    for (unsigned int r = 0; r < _rows.size(); ++r)
+        if (_rows[r] < _valid) {
+            std::copy(_keys.begin() + r * width, _keys.begin() + (r + 1) * width, _keys.begin() + kept * width);
+            _rows[kept++] = _rows[r];
+        }
+    _keys.resize(kept * width);
+    _rows.resize(kept);
+}
@@ -0,0 +1,210 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _SORTED_INDEX_HPP_
+#define _SORTED_INDEX_HPP_
+
+#include <vector>
+
+#include "definition.hpp"
+#include "term.hpp"
+
+class Predicate;
+
+
+
+/**
+ * SortedIndex is the ordered extension of a predicate (or a range of it) sorted on some argument
+ * positions (its columns), as needed by the leapfrog join (cf. LeapfrogJoin) : the tuples that
+ * agree on the first columns are contiguous, and are sorted on the next column.
+ * Terms are compared by address (ground terms are hash-consed).
+ * The sorted keys are stored flat, one row of _columns.size() terms for each tuple, with the index
+ * of the tuple in the ordered extension.
+ *
+ * The index of a predicate over its whole extension (cf. Predicate::getSortedIndex) follows the
+ * extension : new tuples are sorted and merged, tuples removed by back-track are dropped.
+ */
+class SortedIndex{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// argument positions, in sort order
+        intVector _columns;
+
+        /// sorted keys (one row of _columns.size() terms by tuple)
+        Term::Vector _keys;
+
+        /// for each row, index of the tuple in the ordered extension
+        intVector _rows;
+
+        /// the rows are the tuples of index lower than _size in the ordered extension
+        int _size;
+
+        /// tuples of index greater or equal to _valid have been removed from the extension since the last update
+        int _valid;
+
+        /// number of modifications of the rows
+        int _version;
+
+
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+    public:
+        /// mutex of the indexes of the predicates (several threads may update them)
+        static Mutex& mutex();
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+        SortedIndex();
+
+        explicit SortedIndex(const intVector& columns);
+
+
+//********************************** GETTERS *********************************//
+
+        inline int size() const;
+
+        inline int getVersion() const;
+
+        /// term at column c of row r
+        inline Term* getKey(int r, int c) const;
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// the rows are the tuples of the ordered extension of p between index begin and end
+        void build(Predicate* p, int begin, int end);
+
+        /// the rows are the tuples of the whole ordered extension of p
+        void update(Predicate* p);
+
+        /// tuples of index greater or equal to size are removed from the extension (cf. Predicate::restoreExtension)
+        inline void truncate(int size);
+
+        /// first row of [from, to) whose key at column c is not lower than t, to if there is none
+        /// (rows of [from, to) agree on the columns before c)
+        inline int lowerBound(int from, int to, int c, Term* t) const;
+
+        /// first row of [from, to) whose key at column c is greater than t, to if there is none
+        inline int upperBound(int from, int to, int c, Term* t) const;
+
+    protected:
+        /// sort the tuples of index begin to end of p and merge them with the rows
+        void add(Predicate* p, int begin, int end);
+
+        /// remove the rows of the tuples of index greater or equal to _valid
+        void drop();
+
+        /// true if row a of keys ka is lower than row b of keys kb
+        inline bool lower(const Term::Vector& ka, int a, const Term::Vector& kb, int b) const;
+
+
+}; // class SortedIndex
+
+
+//********************************** GETTERS *********************************//
+
+inline int SortedIndex::size() const{
+    return _rows.size();
+}
+
+
+inline int SortedIndex::getVersion() const{
+    return _version;
+}
+
+
+inline Term* SortedIndex::getKey(int r, int c) const{
+    return _keys[r * _columns.size() + c];
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline void SortedIndex::truncate(int size){
+    if (size < _valid)
+        _valid = size;
+}
+
+
+// galloping search : the leapfrog join mostly seeks keys close to the current row
+inline int SortedIndex::lowerBound(int from, int to, int c, Term* t) const{
+    int step = 1;
+    while ((from < to) && (getKey(from, c) < t)) {
+        int probe = from + step;
+        if ((probe >= to) || !(getKey(probe, c) < t)) {
+            int lo = from + 1;
+            int hi = (probe < to) ? probe : to;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (getKey(mid, c) < t)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+        from = probe;
+        step *= 2;
+    }
+    return from;
+}
+
+
+inline int SortedIndex::upperBound(int from, int to, int c, Term* t) const{
+    int step = 1;
+    while ((from < to) && !(t < getKey(from, c))) {
+        int probe = from + step;
+        if ((probe >= to) || (t < getKey(probe, c))) {
+            int lo = from + 1;
+            int hi = (probe < to) ? probe : to;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (t < getKey(mid, c))
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            return lo;
+        }
+        from = probe;
+        step *= 2;
+    }
+    return from;
+}
+
+
+inline bool SortedIndex::lower(const Term::Vector& ka, int a, const Term::Vector& kb, int b) const{
+    unsigned int width = _columns.size();
+    for (unsigned int c = 0; c < width; ++c) {
+        Term* x = ka[a * width + c];
+        Term* y = kb[b * width + c];
+        if (x != y)
+            return x < y;
+    }
+    return false;
+}
+
+
+
+#endif // _SORTED_INDEX_HPP_
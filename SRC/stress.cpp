@@ -0,0 +1,132 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+// Stress test of the solvers of different threads (cf. Solver and Context) : the answer sets of each
+// program, solved by several threads at once and in different orders, must be those of a sequential
+// run. Usage : asperix-stress threads n rounds files... (n answer sets of each program, 0 for all)
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "solver.hpp"
+#include "threads.hpp"
+
+using namespace std;
+
+
+// answer sets of a program, each one as its sorted atoms, in increasing order
+typedef vector<string> AnswerSets;
+
+
+// keep the answer sets as text
+class Collector : public AnswerSetHandler{
+    public:
+        AnswerSets _sets;
+
+        bool answerSet(const AnswerSet& as){
+            vector<string> atoms;
+            for (AnswerSet::const_iterator it = as.begin(); it != as.end(); ++it) {
+                ostringstream atom;
+                atom << *it;
+                atoms.push_back(atom.str());
+            }
+            sort(atoms.begin(), atoms.end());
+            string set;
+            for (vector<string>::iterator it = atoms.begin(); it != atoms.end(); ++it)
+                set += *it + ' ';
+            _sets.push_back(set);
+            return true;
+        }
+};
+
+
+static vector<string> files;
+static vector<AnswerSets> expected;     // answer sets of the sequential run
+static int answerSets;
+static int rounds;
+static int failures = 0;
+static Mutex failuresMutex;
+
+
+static const string error = "error : ";
+
+
+// an error is an answer "set" too, so that a program that fails must fail in every thread
+static AnswerSets solve(const string& fileName){
+    Solver solver;
+    Collector collector;
+    try {
+        solver.loadFile(fileName);
+        solver.solve(collector, answerSets);
+    }
+    catch (const exception& e) {
+        collector._sets.push_back(error + e.what());
+    }
+    sort(collector._sets.begin(), collector._sets.end());
+    return collector._sets;
+}
+
+
+// thread number arg solves the programs from the one of its number, in each round
+static void* work(void* arg){
+    long number = reinterpret_cast<long>(arg);
+    for (int round = 0; round < rounds; ++round)
+        for (unsigned int k = 0; k < files.size(); ++k) {
+            unsigned int i = (k + number + round) % files.size();
+            if (solve(files[i]) != expected[i]) {
+                MutexLock lock(failuresMutex);
+                ++failures;
+                cerr << "Thread " << number << " : wrong answer sets for " << files[i] << endl;
+            }
+        }
+    return NULL;
+}
+
+
+int main(int argc, char** argv){
+    if (argc < 5) {
+        cerr << "Usage : " << argv[0] << " threads n rounds files..." << endl;
+        return 2;
+    }
+    int threads = atoi(argv[1]);
+    answerSets = atoi(argv[2]);
+    rounds = atoi(argv[3]);
+    files.assign(argv + 4, argv + argc);
+    for (vector<string>::iterator it = files.begin(); it != files.end(); ++it) {
+        expected.push_back(solve(*it));
+        const AnswerSets& sets = expected.back();
+        if ((sets.size() == 1) && (sets[0].compare(0, error.size(), error) == 0))
+            cout << *it << " : " << sets[0] << endl;
+        else
+            cout << *it << " : " << sets.size() << " answer set(s)" << endl;
+    }
+    vector<pthread_t> ids(threads);
+    for (long t = 0; t < threads; ++t)
+        pthread_create(&ids[t], NULL, work, reinterpret_cast<void*>(t));
+    for (int t = 0; t < threads; ++t)
+        pthread_join(ids[t], NULL);
+    cout << threads << " threads, " << rounds << " round(s) : " << failures << " failure(s)" << endl;
+    return (failures == 0) ? 0 : 1;
+}
@@ -26,6 +26,7 @@
 //************************** STATIC MEMBER FUNCTIONS *************************//
 
 SymbConst* SymbConst::new_SymbConst(const std::string& name){
+    MutexLock lock(factoryMutex());
     Functor* f = Functor::newFunctor(name, 0);
     Argument a;
     SymbConst* t = static_cast<SymbConst*>( f->existGroundTerm(a) );
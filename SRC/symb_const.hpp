@@ -72,6 +72,8 @@ class SymbConst : public FuncTerm{
 
         inline Term* applySubstitution();
 
+        inline Term* findSubstitution();
+
         inline void free();
 
         inline Term* getClone(MapVariables&);
@@ -125,6 +127,11 @@ inline Term* SymbConst::applySubstitution(){
 }
 
 
+inline Term* SymbConst::findSubstitution(){
+    return this;
+}
+
+
 inline void SymbConst::free(){}
 
 
@@ -20,6 +20,7 @@
 
 
 #include "arith_expr.hpp"
+#include "context.hpp"
 #include "func_term.hpp"
 #include "num_const.hpp"
 #include "operator.hpp"
@@ -41,6 +42,13 @@ void Term::delete_all(){
 }
 
 
+// mutex of the factories of terms : a ground term must be created once only
+// (the threads of an evaluation share the terms of their context)
+Mutex& Term::factoryMutex(){
+    return Context::current()->_factoryMutex;
+}
+
+
 //******************************** DESTRUCTOR ********************************//
 
 Term::~Term(){}
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "definition.hpp"
+#include "threads.hpp"
 
 
 class Argument;
@@ -44,6 +45,9 @@ class Term{ // abstract class
 
         static void delete_all();
 
+        /// mutex of the factories of terms (several SCCs may be evaluated at the same time)
+        static Mutex& factoryMutex();
+
 
 //******************************** DESTRUCTOR ********************************//
 
@@ -89,6 +93,9 @@ class Term{ // abstract class
         /// default value
         virtual inline bool isFuncTerm();
 
+        /// default value
+        virtual inline bool isVariable();
+
         /// default value
         virtual inline bool isList();
 
@@ -112,6 +119,10 @@ class Term{ // abstract class
 
         virtual inline Term* applySubstitution();
 
+        /// ground term of the current substitution if it already exists, NULL otherwise
+        /// (unlike applySubstitution, no term is created when it can be avoided)
+        virtual inline Term* findSubstitution();
+
         virtual inline Term* getClone(MapVariables&);
 
     private:
@@ -178,6 +189,12 @@ inline bool Term::isFuncTerm(){
 }
 
 
+// default value
+inline bool Term::isVariable(){
+    return false;
+}
+
+
 // default value
 inline bool Term::isList(){
     return false;
@@ -190,6 +207,12 @@ inline Term* Term::applySubstitution(){
 }
 
 
+// default method : constants, and arithmetic expressions whose value may be a new number
+inline Term* Term::findSubstitution(){
+    return applySubstitution();
+}
+
+
 // default method
 inline Term* Term::getClone(MapVariables&){
     return this;
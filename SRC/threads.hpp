@@ -0,0 +1,229 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+
+#ifndef _THREADS_HPP_
+#define _THREADS_HPP_
+
+#include <pthread.h>
+
+
+
+//****************************************************************************//
+//                                   Mutex                                    //
+//****************************************************************************//
+
+
+/**
+ * Mutex is a recursive POSIX mutex : the thread that holds it can lock it again
+ */
+class Mutex{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        pthread_mutex_t _mutex;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        inline Mutex();
+
+    private:
+        /// not copyable
+        Mutex(const Mutex&);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+    public:
+        inline ~Mutex();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        inline void lock();
+
+        inline void unlock();
+
+        /// underlying POSIX mutex (for condition variables)
+        inline pthread_mutex_t* getHandle();
+
+
+}; // class Mutex
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline Mutex::Mutex(){
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+inline Mutex::~Mutex(){
+    pthread_mutex_destroy(&_mutex);
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline void Mutex::lock(){
+    pthread_mutex_lock(&_mutex);
+}
+
+
+inline void Mutex::unlock(){
+    pthread_mutex_unlock(&_mutex);
+}
+
+
+inline pthread_mutex_t* Mutex::getHandle(){
+    return &_mutex;
+}
+
+
+
+
+
+//****************************************************************************//
+//                                 MutexLock                                  //
+//****************************************************************************//
+
+
+/**
+ * MutexLock locks a mutex from its construction to its destruction (end of block)
+ */
+class MutexLock{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        Mutex& _mutex;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        inline MutexLock(Mutex& m);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+        inline ~MutexLock();
+
+
+}; // class MutexLock
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline MutexLock::MutexLock(Mutex& m) : _mutex(m){
+    _mutex.lock();
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+inline MutexLock::~MutexLock(){
+    _mutex.unlock();
+}
+
+
+
+
+
+//****************************************************************************//
+//                                 Condition                                  //
+//****************************************************************************//
+
+
+/**
+ * Condition is a POSIX condition variable, used with a Mutex locked once
+ */
+class Condition{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        pthread_cond_t _cond;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        inline Condition();
+
+    private:
+        /// not copyable
+        Condition(const Condition&);
+
+
+//******************************** DESTRUCTOR ********************************//
+
+    public:
+        inline ~Condition();
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+        /// release m (locked once by the calling thread) until the condition is signaled
+        inline void wait(Mutex& m);
+
+        inline void broadcast();
+
+
+}; // class Condition
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline Condition::Condition(){
+    pthread_cond_init(&_cond, NULL);
+}
+
+
+//******************************** DESTRUCTOR ********************************//
+
+inline Condition::~Condition(){
+    pthread_cond_destroy(&_cond);
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+inline void Condition::wait(Mutex& m){
+    pthread_cond_wait(&_cond, m.getHandle());
+}
+
+
+inline void Condition::broadcast(){
+    pthread_cond_broadcast(&_cond);
+}
+
+
+
+#endif // _THREADS_HPP_
@@ -0,0 +1,158 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+/**
+ * @file
+ * @brief Declarations of the class giving access to a tuple of a predicate extension.
+ */
+
+
+#ifndef _TUPLE_HPP_
+#define _TUPLE_HPP_
+
+#include <algorithm>
+#include <iostream>
+
+#include "term.hpp"
+
+
+
+/**
+ * @brief A view on the ground terms of a tuple stored in a TupleTable.
+ * 
+ * The terms of all the tuples of a table are stored contiguously, so a
+ * tuple is only a pointer to its first term and its arity. A view is valid
+ * until the next insertion in the table (which may move the terms).
+ * 
+ * The null tuple (no tuple found) has a negative size.
+ */
+class Tuple{
+
+//******************************* NESTED TYPES *******************************//
+
+    public:
+        typedef Term* const* const_iterator;
+
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        const_iterator _terms;
+
+        int _size;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        /// the null tuple
+        inline Tuple();
+
+        inline Tuple(const_iterator terms, int size);
+
+
+//********************************** GETTERS *********************************//
+
+        inline bool isNull() const;
+
+        inline int size() const;
+
+        inline bool empty() const;
+
+        inline const_iterator begin() const;
+
+        inline const_iterator end() const;
+
+
+//********************************* OPERATORS ********************************//
+
+        inline Term* operator [] (int pos) const;
+
+        /// same terms (the ground terms are hash-consed)
+        inline bool operator == (const Term::Vector& tv) const;
+
+    private:
+        friend inline std::ostream& operator << (std::ostream& os, const Tuple& t);
+
+
+}; // class Tuple
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+inline Tuple::Tuple() : _terms(NULL), _size(-1){}
+
+
+inline Tuple::Tuple(const_iterator terms, int size) : _terms(terms), _size(size){}
+
+
+//********************************** GETTERS *********************************//
+
+inline bool Tuple::isNull() const{
+    return _size < 0;
+}
+
+
+inline int Tuple::size() const{
+    return _size;
+}
+
+
+inline bool Tuple::empty() const{
+    return _size <= 0;
+}
+
+
+inline Tuple::const_iterator Tuple::begin() const{
+    return _terms;
+}
+
+
+inline Tuple::const_iterator Tuple::end() const{
+    return _terms + _size;
+}
+
+
+//********************************* OPERATORS ********************************//
+
+inline Term* Tuple::operator [] (int pos) const{
+    return _terms[pos];
+}
+
+
+inline bool Tuple::operator == (const Term::Vector& tv) const{
+    return ((int) tv.size() == _size) && std::equal(tv.begin(), tv.end(), _terms);
+}
+
+
+// as an Argument : p(a,1) is written p followed by (a,1)
+inline std::ostream& operator << (std::ostream& os, const Tuple& t){
+    if (!t.empty()) {
+        os << '(';
+        for (Tuple::const_iterator it = t.begin(); it != t.end(); it++)
+            os << ((it == t.begin()) ? "" : ",") << **it;
+        os << ')';
+    }
+    return os;
+}
+
+
+
+#endif // _TUPLE_HPP_
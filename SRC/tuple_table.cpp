@@ -0,0 +1,115 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+/**
+ * @file
+ * @brief Definition of members of the class storing the tuples of a predicate extension.
+ */
+
+
+#include <algorithm>
+
+#include "tuple_table.hpp"
+
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+TupleTable::TupleTable(int arity) : _arity(arity), _terms(), _status(), _index(), _update_index(), _slots(8, -1), _mask(7){}
+
+
+//********************************* OPERATORS ********************************//
+
+std::ostream& operator << (std::ostream& os, const TupleTable& t){
+    os << '{';
+    for (int id = 0; id < t.size(); ++id)
+        os << ((id == 0) ? "" : ",") << t.getTuple(id) << t._status[id];
+    return os << '}' << std::endl;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// add tv (which is not in the table) with status st and insertion index index, and return its number
+int TupleTable::insert(const Argument& tv, statusEnum st, int index){
+    if (2 * (_status.size() + 1) > _slots.size())     // load factor <= 1/2
+        grow(2 * _slots.size());
+    int id = _status.size();
+    _terms.insert(_terms.end(), tv.begin(), tv.end());
+    _status.push_back(st);
+    _index.push_back(index);
+    _update_index.push_back(-1);
+    size_t i = hash(tv) & _mask;
+    while (_slots[i] >= 0)
+        i = (i + 1) & _mask;
+    _slots[i] = id;
+    return id;
+}
+
+
+/* Remove the last inserted tuple.
+ * The probe sequence of a tuple only goes through slots of tuples inserted
+ * before it, so freeing the slot of the last tuple doesn't break the others.
+ */
+void TupleTable::removeLast(){
+    int id = _status.size() - 1;
+    size_t i = hash(getTuple(id)) & _mask;
+    while (_slots[i] != id)
+        i = (i + 1) & _mask;
+    _slots[i] = -1;
+    _terms.resize(id * _arity);
+    _status.pop_back();
+    _index.pop_back();
+    _update_index.pop_back();
+}
+
+
+// the vectors grow at least geometrically : reserving room for a few tuples at a time stays linear
+void TupleTable::reserve(size_t n){
+    size_t needed = _status.size() + n;
+    size_t slots = _slots.size();
+    while (2 * needed > slots)
+        slots *= 2;
+    if (slots > _slots.size())
+        grow(slots);
+    if (needed > _status.capacity()) {
+        needed = std::max(needed, 2 * _status.capacity());
+        _terms.reserve(needed * _arity);
+        _status.reserve(needed);
+        _index.reserve(needed);
+        _update_index.reserve(needed);
+    }
+}
+
+
+// resize the hash table and re-insert all tuples (in insertion order)
+void TupleTable::grow(size_t slots){
+    _slots.assign(slots, -1);
+    _mask = _slots.size() - 1;
+    for (int id = 0; id < size(); ++id) {
+        size_t i = hash(getTuple(id)) & _mask;
+        while (_slots[i] >= 0)
+            i = (i + 1) & _mask;
+        _slots[i] = id;
+    }
+}
+
+
+
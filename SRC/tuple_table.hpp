@@ -0,0 +1,223 @@
+/* *************************************************************************
+ * Copyright (C) 2007-2013 
+ * Claire Lefèvre, Pascal Nicolas, Stéphane Ngoma, Christopher Béatrix
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * claire.lefevre@univ-angers.fr	christopher.beatrix@univ-angers.fr
+ ****************************************************************************/  
+
+/**
+ * @file
+ * @brief Declarations of the class storing the tuples of a predicate extension.
+ */
+
+
+#ifndef _TUPLE_TABLE_HPP_
+#define _TUPLE_TABLE_HPP_
+
+#include <iostream>
+#include <vector>
+
+#include "arguments.hpp"
+#include "definition.hpp"
+#include "tuple.hpp"
+
+
+
+/**
+ * @brief A flat hash table of ground tuples, each one with its status.
+ * 
+ * Tuples are numbered in insertion order. A table has the arity of its
+ * predicate : the terms of all the tuples are stored in a single vector,
+ * tuple id occupying the arity terms from id * arity (cf. Tuple). The hash table uses
+ * open addressing with linear probing on the addresses of the (hash-consed)
+ * ground terms of a tuple.
+ * 
+ * Tuples can only be removed in the reverse order of insertion, which is the
+ * order of back-track: removing the last tuple frees its slot and truncates
+ * the terms.
+ */
+class TupleTable{
+
+//***************************** MEMBER VARIABLES *****************************//
+
+    protected:
+        /// number of terms of a tuple
+        int _arity;
+
+        /// terms of the tuples, in insertion order
+        Term::Vector _terms;
+
+        /// status of each tuple
+        std::vector<statusEnum> _status;
+
+        /// for each tuple, index of its insertion in the ordered extension of the predicate
+        intVector _index;
+
+        /// for each tuple, index of its update from MBT_ to TRUE_MBT_ in the ordered extension, or -1
+        intVector _update_index;
+
+        /// hash table : number of a tuple, or -1 for an empty slot
+        intVector _slots;
+
+        /// _slots.size() - 1 (_slots size is a power of 2)
+        size_t _mask;
+
+
+//******************************* CONSTRUCTORS *******************************//
+
+    public:
+        explicit TupleTable(int arity);
+
+
+//********************************** GETTERS *********************************//
+
+        inline int size() const;
+
+        /// valid until the next insertion
+        inline Tuple getTuple(int id) const;
+
+        inline statusEnum getStatus(int id) const;
+
+        /// status of tuple id when only the ordered extension between index begin and end is considered
+        inline statusEnum getStatus(int id, int begin, int end) const;
+
+        /// index of the last insertion or update of tuple id in the ordered extension
+        inline int getIndex(int id) const;
+
+        /// index of tuple id when only the ordered extension between index begin and end is considered, or -1
+        inline int getIndex(int id, int begin, int end) const;
+
+
+//********************************** SETTERS *********************************//
+
+        /// index is the index of the update in the ordered extension (-1 if st is not TRUE_MBT_)
+        inline void setStatus(int id, statusEnum st, int index);
+
+
+//********************************* OPERATORS ********************************//
+
+    private:
+        friend std::ostream& operator << (std::ostream& os, const TupleTable& t);
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+    public:
+        /// number of tuple tv, or -1 if tv is not in the table
+        inline int find(const Argument& tv) const;
+
+        /// add tv (which is not in the table) with status st and insertion index index, and return its number
+        int insert(const Argument& tv, statusEnum st, int index);
+
+        /// remove the last inserted tuple
+        void removeLast();
+
+        /// make room for n more tuples, without re-hashing while they are inserted
+        void reserve(size_t n);
+
+    protected:
+        /// h(tv[0],...,tv[n-1]) : the same for an argument and for a tuple with the same terms
+        template<class Terms> static inline size_t hash(const Terms& tv);
+
+        /// resize the hash table to slots (a power of 2) and re-insert all tuples
+        void grow(size_t slots);
+
+
+}; // class TupleTable
+
+
+//********************************** GETTERS *********************************//
+
+inline int TupleTable::size() const{
+    return _status.size();
+}
+
+
+inline Tuple TupleTable::getTuple(int id) const{
+    return Tuple(_arity ? &_terms[id * _arity] : NULL, _arity);
+}
+
+
+inline statusEnum TupleTable::getStatus(int id) const{
+    return _status[id];
+}
+
+
+/* A tuple appears at most twice in the ordered extension : at its insertion
+ * (with status MBT_ or TRUE_) and at its update (with status TRUE_MBT_).
+ * The status of its last occurrence in [begin,end] is returned, NO_ if none.
+ */
+inline statusEnum TupleTable::getStatus(int id, int begin, int end) const{
+    if ((_update_index[id] >= begin) && (_update_index[id] <= end))
+        return TRUE_MBT_;
+    else if ((_index[id] >= begin) && (_index[id] <= end))
+        return (_status[id] == TRUE_MBT_) ? MBT_ : _status[id];
+    else
+        return NO_;
+}
+
+
+inline int TupleTable::getIndex(int id) const{
+    return (_update_index[id] >= 0) ? _update_index[id] : _index[id];
+}
+
+
+inline int TupleTable::getIndex(int id, int begin, int end) const{
+    if ((_update_index[id] >= begin) && (_update_index[id] <= end))
+        return _update_index[id];
+    else if ((_index[id] >= begin) && (_index[id] <= end))
+        return _index[id];
+    else
+        return -1;
+}
+
+
+//********************************** SETTERS *********************************//
+
+inline void TupleTable::setStatus(int id, statusEnum st, int index){
+    _status[id] = st;
+    _update_index[id] = index;
+}
+
+
+//************************** OTHER MEMBER FUNCTIONS **************************//
+
+// ground terms are hash-consed, so the hash of a tuple only depends on term addresses
+template<class Terms> inline size_t TupleTable::hash(const Terms& tv){
+    size_t h = tv.size();
+    for (typename Terms::const_iterator it = tv.begin(); it != tv.end(); ++it)
+        h ^= reinterpret_cast<size_t>(*it) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= h >> 16;
+    h *= 0x45d9f3b;
+    h ^= h >> 16;
+    return h;
+}
+
+
+// number of tuple tv, or -1 if tv is not in the table
+inline int TupleTable::find(const Argument& tv) const{
+    size_t i = hash(tv) & _mask;
+    while (_slots[i] >= 0) {
+        if (getTuple(_slots[i]) == tv)
+            return _slots[i];
+        i = (i + 1) & _mask;
+    }
+    return -1;
+}
+
+
+
+#endif // _TUPLE_TABLE_HPP_
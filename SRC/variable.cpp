@@ -25,12 +25,6 @@
 
 
 
-//************************** STATIC MEMBER VARIABLES *************************//
-
-// initialization of static variable
-int Variable::_nextNumber = 0;
-
-
 //******************************* CONSTRUCTORS *******************************//
 
 Variable::Variable(){}
@@ -39,7 +33,7 @@ Variable::Variable(){}
 Variable::Variable(const std::string& s) : _userName(s){
     // generate the next variable name
     std::stringstream ss;
-    ss << "__" << _nextNumber++;    // cast int2string
+    ss << "__" << _nextNumber()++;    // cast int2string
     ss >> _name;
     _subst = NULL;
 }
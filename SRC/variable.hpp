@@ -25,6 +25,7 @@
 #include <set>
 #include <string>
 
+#include "context.hpp"
 #include "definition.hpp"
 #include "term.hpp"
 
@@ -36,7 +37,7 @@ class Variable : public Term{
 
     protected:
         /// number for the next new variable
-        static int _nextNumber;
+        static inline int& _nextNumber();
 
 
 //***************************** MEMBER VARIABLES *****************************//
@@ -85,10 +86,20 @@ class Variable : public Term{
         /// free the variable
         inline void free();
 
+        /// bind the free variable to the ground term t (cf. RulePlan)
+        inline void bind(Term* t);
+
+        /// ground term bound to the variable, NULL if it is free
+        inline Term* getSubst() const;
+
         bool match(Term* t);
 
+        inline bool isVariable();
+
         inline Term* applySubstitution();
 
+        inline Term* findSubstitution();
+
         inline Variable* getClone(MapVariables&);
 
         inline void recordSubstitution();
@@ -102,6 +113,13 @@ class Variable : public Term{
 }; // class Variable
 
 
+//************************** STATIC MEMBER FUNCTIONS *************************//
+
+inline int& Variable::_nextNumber(){
+    return Context::current()->_nextNumber;
+}
+
+
 //********************************** GETTERS *********************************//
 
 inline const std::string& Variable::getUserName() const{
@@ -140,6 +158,21 @@ inline void Variable::free(){
 }
 
 
+inline void Variable::bind(Term* t){
+    _subst = t;
+}
+
+
+inline Term* Variable::getSubst() const{
+    return _subst;
+}
+
+
+inline bool Variable::isVariable(){
+    return true;
+}
+
+
 inline Term* Variable::applySubstitution(){
     if (_subst)
         return _subst;
@@ -148,6 +181,11 @@ inline Term* Variable::applySubstitution(){
 }
 
 
+inline Term* Variable::findSubstitution(){
+    return applySubstitution();
+}
+
+
 inline Variable* Variable::getClone(MapVariables& mapVar){
     MapVariables::iterator it = mapVar.find(this);
     if (it != mapVar.end())